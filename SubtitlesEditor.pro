@@ -1,12 +1,52 @@
 # -------------------------------------------------
 # Project created by QtCreator 2010-04-20T08:57:59
 # -------------------------------------------------
+QT += concurrent
 QT += multimedia
 QT += multimediawidgets
 QT += widgets
 TARGET = SubtitlesEditor
 TEMPLATE = app
+include(src/SubtitlesCore.pri)
 SOURCES += src/main.cpp \
-	src/SubtitlesEditor.cpp
-HEADERS += src/SubtitlesEditor.h
+	src/PlaybackClock.cpp \
+	src/RetimeDialog.cpp \
+	src/SearchBrowser.cpp \
+	src/SearchIndex.cpp \
+	src/SeekScheduler.cpp \
+	src/SequencesBrowser.cpp \
+	src/SequencesCatalog.cpp \
+	src/SequencesIndexer.cpp \
+	src/SequencesLoader.cpp \
+	src/SubtitlesBatch.cpp \
+	src/SubtitlesEditor.cpp \
+	src/SubtitlesHistory.cpp \
+	src/SubtitlesJournal.cpp \
+	src/SubtitlesModel.cpp \
+	src/SubtitlesOverlay.cpp \
+	src/SubtitlesTable.cpp \
+	src/SubtitlesTimeline.cpp \
+	src/ThumbnailLoader.cpp \
+	src/TimeSpinBox.cpp \
+	src/WaveformLoader.cpp
+HEADERS += src/PlaybackClock.h \
+	src/RetimeDialog.h \
+	src/SearchBrowser.h \
+	src/SearchIndex.h \
+	src/SeekScheduler.h \
+	src/SequencesBrowser.h \
+	src/SequencesCatalog.h \
+	src/SequencesIndexer.h \
+	src/SequencesLoader.h \
+	src/SubtitlesBatch.h \
+	src/SubtitlesEditor.h \
+	src/SubtitlesHistory.h \
+	src/SubtitlesJournal.h \
+	src/SubtitlesModel.h \
+	src/SubtitlesOverlay.h \
+	src/SubtitlesTable.h \
+	src/SubtitlesTimeline.h \
+	src/ThumbnailLoader.h \
+	src/TimeSpinBox.h \
+	src/WaveformLoader.h
 FORMS += src/SubtitlesEditor.ui
@@ -0,0 +1,109 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "CorpusGenerator.h"
+#include "SubtitlesParser.h"
+
+static const char *words[] = {"Commander", "the", "Collective", "has", "launched", "an", "attack", "on", "our", "base", "Nexus", "project", "transport", "is", "ready", "for", "take-off", "we", "must", "recover", "artifacts", "before", "New Paradigm", "forces", "arrive", "żołnierze", "Ausrüstung", "données"};
+
+CorpusGenerator::CorpusGenerator(quint32 seed) : m_state(seed),
+	m_duration(0)
+{
+}
+
+QByteArray CorpusGenerator::generate(int count)
+{
+	QByteArray data;
+	qint64 time = 0;
+
+	data.reserve(count * 64);
+	data.append("// Generated subtitles corpus\n");
+
+	for (int i = 0; i < count; ++i)
+	{
+		const qint64 begin = (time + random(500));
+		const qint64 end = (begin + 1000 + random(3000));
+
+		data.append(QByteArray::number(20 + random(40)));
+		data.append('\t');
+		data.append(QByteArray::number(random(2) ? 432 : 20));
+		data.append("\t\t");
+		data.append(QByteArray::number(begin / 1000));
+		data.append('.');
+		data.append(QByteArray::number((begin % 1000) / 100));
+		data.append('\t');
+		data.append(QByteArray::number(end / 1000));
+		data.append('.');
+		data.append(QByteArray::number((end % 1000) / 100));
+		data.append("\t_(\"");
+		data.append(randomText());
+		data.append("\")\n");
+
+		if (random(4) == 0)
+		{
+			data.append('\n');
+		}
+
+		time += (1000 + random(1500));
+		m_duration = qMax(m_duration, end);
+	}
+
+	return data;
+}
+
+SubtitlesTrack CorpusGenerator::generateTrack(int count)
+{
+	const QByteArray data = generate(count);
+	SubtitlesParser parser;
+	parser.parse(data.constData(), data.size());
+
+	return parser.track();
+}
+
+qint64 CorpusGenerator::duration() const
+{
+	return m_duration;
+}
+
+quint32 CorpusGenerator::random(quint32 maximum)
+{
+	m_state = ((m_state * 1103515245) + 12345);
+
+	return ((m_state >> 8) % maximum);
+}
+
+QByteArray CorpusGenerator::randomText()
+{
+	const int count = (3 + random(10));
+	QByteArray text;
+
+	for (int i = 0; i < count; ++i)
+	{
+		if (i > 0)
+		{
+			text.append(' ');
+		}
+
+		text.append(words[random(sizeof(words) / sizeof(words[0]))]);
+	}
+
+	return text;
+}
@@ -0,0 +1,291 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesBenchmark.h"
+#include "CorpusGenerator.h"
+#include "SubtitlesBinary.h"
+#include "SubtitlesCorpus.h"
+#include "SubtitlesParser.h"
+#include "SubtitlesRetimer.h"
+#include "SubtitlesWriter.h"
+#include "WaveformPeaks.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QRandomGenerator>
+#include <QtTest/QtTest>
+
+void SubtitlesBenchmark::addSizes()
+{
+	QTest::addColumn<int>("count");
+
+	QTest::newRow("10") << 10;
+	QTest::newRow("1000") << 1000;
+	QTest::newRow("100000") << 100000;
+	QTest::newRow("1000000") << 1000000;
+}
+
+void SubtitlesBenchmark::parse_data()
+{
+	addSizes();
+}
+
+void SubtitlesBenchmark::parse()
+{
+	QFETCH(int, count);
+
+	const QByteArray data = CorpusGenerator().generate(count);
+	SubtitlesParser parser;
+
+	QBENCHMARK
+	{
+		parser.parse(data.constData(), data.size());
+	}
+
+	QCOMPARE(parser.track().count(), count);
+}
+
+void SubtitlesBenchmark::parseThroughput()
+{
+	const QByteArray data = CorpusGenerator().generate(1000000);
+	SubtitlesParser parser;
+
+	QBENCHMARK
+	{
+		parser.parse(data.constData(), data.size());
+	}
+
+	QCOMPARE(parser.track().count(), 1000000);
+
+	if (!qEnvironmentVariableIsSet("SUBTITLES_BENCHMARK_TARGETS"))
+	{
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	parser.parse(data.constData(), data.size());
+
+	const double throughput = ((data.size() / (1024.0 * 1024.0)) / qMax(0.001, (timer.nsecsElapsed() / 1000000000.0)));
+
+	QVERIFY2(throughput >= SubtitlesParser::ThroughputTarget, "Parser throughput is below target");
+}
+
+void SubtitlesBenchmark::format_data()
+{
+	addSizes();
+}
+
+void SubtitlesBenchmark::format()
+{
+	QFETCH(int, count);
+
+	const SubtitlesTrack track = CorpusGenerator().generateTrack(count);
+	SubtitlesWriter writer;
+
+	QBENCHMARK
+	{
+		writer.format(track);
+	}
+}
+
+void SubtitlesBenchmark::playback_data()
+{
+	addSizes();
+}
+
+void SubtitlesBenchmark::playback()
+{
+	QFETCH(int, count);
+
+	CorpusGenerator generator;
+	SubtitlesTrack track = generator.generateTrack(count);
+	const qint64 start = (generator.duration() / 2);
+
+	track.seek(start);
+
+	QBENCHMARK
+	{
+		track.invalidate();
+
+		for (int i = 0; i < 1000; ++i)
+		{
+			track.seek(start + (i * 100));
+		}
+	}
+}
+
+void SubtitlesBenchmark::seek_data()
+{
+	addSizes();
+}
+
+void SubtitlesBenchmark::seek()
+{
+	QFETCH(int, count);
+
+	CorpusGenerator generator;
+	SubtitlesTrack track = generator.generateTrack(count);
+	QVector<qint64> positions;
+	positions.reserve(1000);
+
+	QRandomGenerator random(count);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		positions.append(qint64(random.generateDouble() * generator.duration()));
+	}
+
+	track.seek(0);
+
+	QBENCHMARK
+	{
+		for (int i = 0; i < positions.count(); ++i)
+		{
+			track.seek(positions.at(i));
+		}
+	}
+}
+
+void SubtitlesBenchmark::rescale_data()
+{
+	addSizes();
+}
+
+void SubtitlesBenchmark::rescale()
+{
+	QFETCH(int, count);
+
+	SubtitlesTrack source = CorpusGenerator().generateTrack(count);
+	source.seek(0);
+
+	QBENCHMARK
+	{
+		SubtitlesTrack track(source);
+		track.transform(0.999);
+	}
+}
+
+void SubtitlesBenchmark::retime_data()
+{
+	addSizes();
+}
+
+void SubtitlesBenchmark::retime()
+{
+	QFETCH(int, count);
+
+	const SubtitlesTrack track = CorpusGenerator().generateTrack(count);
+	const SubtitlesRetimer retimer = SubtitlesRetimer::fit(1000, 1200, 3600000, 3610000);
+	QVector<qint64> begins = track.beginTimes();
+	QVector<qint64> ends = track.endTimes();
+
+	QBENCHMARK
+	{
+		retimer.apply(&begins, &ends, 0, (count - 1));
+	}
+}
+
+void SubtitlesBenchmark::compiled_data()
+{
+	addSizes();
+}
+
+void SubtitlesBenchmark::compiled()
+{
+	QFETCH(int, count);
+
+	const SubtitlesTrack track = CorpusGenerator().generateTrack(count);
+	const QByteArray data = SubtitlesBinary::compile(track);
+	const qint64 duration = track.end(count - 1);
+
+	QBENCHMARK
+	{
+		SubtitlesBinary binary;
+		binary.setData(data);
+
+		for (qint64 time = 0; time < duration; time += (duration / 1000) + 1)
+		{
+			binary.activeSubtitles(time);
+		}
+	}
+
+	SubtitlesBinary binary;
+
+	QVERIFY(binary.setData(data));
+	QVERIFY(binary.verify(track));
+}
+
+void SubtitlesBenchmark::timeToString()
+{
+	char buffer[32];
+
+	QBENCHMARK
+	{
+		for (qint64 time = 0; time < 1000000; time += 1000)
+		{
+			SubtitlesWriter::formatTime(time, buffer, true);
+		}
+	}
+}
+
+void SubtitlesBenchmark::waveform()
+{
+	QVector<qint16> samples(2 * 44100 * 60);
+
+	for (int i = 0; i < samples.count(); ++i)
+	{
+		samples[i] = qint16(quint16((quint32(i) * 7919) % 65536));
+	}
+
+	QBENCHMARK
+	{
+		WaveformPeaks peaks;
+		peaks.setSampleRate(44100);
+		peaks.appendSamples(samples.constData(), (samples.count() / 2), 2);
+		peaks.finish();
+	}
+}
+
+void SubtitlesBenchmark::corpus()
+{
+	CorpusGenerator generator;
+	QList<SubtitlesTrack> tracks;
+
+	for (int i = 0; i < 200; ++i)
+	{
+		tracks.append(generator.generateTrack(500));
+	}
+
+	SubtitlesCorpus corpus;
+
+	QBENCHMARK_ONCE
+	{
+		for (int i = 0; i < tracks.count(); ++i)
+		{
+			corpus.addTrack(QString("track%1.txa").arg(i), tracks.at(i));
+		}
+	}
+
+	QVERIFY(corpus.memoryUsage() < corpus.estimatedListMemoryUsage());
+}
+
+QTEST_APPLESS_MAIN(SubtitlesBenchmark)
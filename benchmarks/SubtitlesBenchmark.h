@@ -0,0 +1,55 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESBENCHMARK_H
+#define SUBTITLESBENCHMARK_H
+
+#include <QtCore/QObject>
+
+class SubtitlesBenchmark : public QObject
+{
+	Q_OBJECT
+
+protected:
+	void addSizes();
+
+private slots:
+	void parse_data();
+	void parse();
+	void parseThroughput();
+	void format_data();
+	void format();
+	void playback_data();
+	void playback();
+	void seek_data();
+	void seek();
+	void rescale_data();
+	void rescale();
+	void retime_data();
+	void retime();
+	void compiled_data();
+	void compiled();
+	void timeToString();
+	void waveform();
+	void corpus();
+};
+
+#endif
@@ -0,0 +1,14 @@
+# -------------------------------------------------
+# Benchmarks for parsing, saving, lookup and retiming
+# -------------------------------------------------
+QT += testlib
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+TARGET = SubtitlesBenchmark
+TEMPLATE = app
+include(../src/SubtitlesCore.pri)
+SOURCES += CorpusGenerator.cpp \
+	SubtitlesBenchmark.cpp
+HEADERS += CorpusGenerator.h \
+	SubtitlesBenchmark.h
@@ -0,0 +1,120 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "PlaybackClock.h"
+
+#include <QtCore/QTimer>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QScreen>
+
+PlaybackClock::PlaybackClock(QObject *parent) : QObject(parent),
+	m_timer(new QTimer(this)),
+	m_anchorPosition(0),
+	m_lastPosition(-1),
+	m_duration(0),
+	m_playbackRate(1),
+	m_running(false)
+{
+	const QScreen *screen = QGuiApplication::primaryScreen();
+	const qreal refreshRate = ((screen && screen->refreshRate() > 0) ? screen->refreshRate() : 60);
+
+	m_timer->setTimerType(Qt::PreciseTimer);
+	m_timer->setInterval(qMax(1, qRound(1000 / refreshRate)));
+
+	m_elapsedTimer.start();
+
+	connect(m_timer, SIGNAL(timeout()), this, SLOT(tick()));
+}
+
+void PlaybackClock::anchor(qint64 position)
+{
+	m_anchorPosition = position;
+
+	m_elapsedTimer.restart();
+
+	tick();
+}
+
+void PlaybackClock::setRunning(bool running)
+{
+	if (running == m_running)
+	{
+		return;
+	}
+
+	m_anchorPosition = position();
+	m_running = running;
+
+	m_elapsedTimer.restart();
+
+	if (running)
+	{
+		m_timer->start();
+	}
+	else
+	{
+		m_timer->stop();
+
+		tick();
+	}
+}
+
+void PlaybackClock::setPlaybackRate(qreal rate)
+{
+	m_anchorPosition = position();
+	m_playbackRate = rate;
+
+	m_elapsedTimer.restart();
+}
+
+void PlaybackClock::setDuration(qint64 duration)
+{
+	m_duration = duration;
+}
+
+void PlaybackClock::tick()
+{
+	const qint64 currentPosition = position();
+
+	if (currentPosition != m_lastPosition)
+	{
+		m_lastPosition = currentPosition;
+
+		emit positionChanged(currentPosition);
+	}
+}
+
+qint64 PlaybackClock::position() const
+{
+	if (!m_running)
+	{
+		return m_anchorPosition;
+	}
+
+	const qint64 position = (m_anchorPosition + qRound64(m_elapsedTimer.elapsed() * m_playbackRate));
+
+	return ((m_duration > 0) ? qMin(position, m_duration) : position);
+}
+
+bool PlaybackClock::isRunning() const
+{
+	return m_running;
+}
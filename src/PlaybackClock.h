@@ -0,0 +1,63 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef PLAYBACKCLOCK_H
+#define PLAYBACKCLOCK_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+
+class QTimer;
+
+class PlaybackClock : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit PlaybackClock(QObject *parent = NULL);
+
+	qint64 position() const;
+	bool isRunning() const;
+
+public slots:
+	void anchor(qint64 position);
+	void setRunning(bool running);
+	void setPlaybackRate(qreal rate);
+	void setDuration(qint64 duration);
+
+protected slots:
+	void tick();
+
+private:
+	QTimer *m_timer;
+	QElapsedTimer m_elapsedTimer;
+	qint64 m_anchorPosition;
+	qint64 m_lastPosition;
+	qint64 m_duration;
+	qreal m_playbackRate;
+	bool m_running;
+
+signals:
+	void positionChanged(qint64 position);
+
+};
+
+#endif
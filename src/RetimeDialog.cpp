@@ -0,0 +1,169 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "RetimeDialog.h"
+#include "TimeSpinBox.h"
+
+#include <QtWidgets/QComboBox>
+#include <QtWidgets/QDialogButtonBox>
+#include <QtWidgets/QDoubleSpinBox>
+#include <QtWidgets/QFormLayout>
+#include <QtWidgets/QPushButton>
+#include <QtWidgets/QSpinBox>
+#include <QtWidgets/QStackedWidget>
+#include <QtWidgets/QVBoxLayout>
+
+static QDoubleSpinBox* createRateSpinBox(double value, QWidget *parent)
+{
+	QDoubleSpinBox *spinBox = new QDoubleSpinBox(parent);
+	spinBox->setDecimals(3);
+	spinBox->setRange(1, 240);
+	spinBox->setValue(value);
+
+	return spinBox;
+}
+
+RetimeDialog::RetimeDialog(bool selection, QWidget *parent) : QDialog(parent),
+	m_modeComboBox(new QComboBox(this)),
+	m_scopeComboBox(new QComboBox(this)),
+	m_stackedWidget(new QStackedWidget(this)),
+	m_offsetSpinBox(new QSpinBox(this)),
+	m_scaleSpinBox(new QDoubleSpinBox(this)),
+	m_sourceRateSpinBox(createRateSpinBox(25, this)),
+	m_targetRateSpinBox(createRateSpinBox(29.97, this)),
+	m_firstSourceTimeEdit(new TimeSpinBox(this)),
+	m_firstTargetTimeEdit(new TimeSpinBox(this)),
+	m_secondSourceTimeEdit(new TimeSpinBox(this)),
+	m_secondTargetTimeEdit(new TimeSpinBox(this)),
+	m_buttonBox(new QDialogButtonBox((QDialogButtonBox::Ok | QDialogButtonBox::Cancel), this))
+{
+	setWindowTitle(tr("Retime Subtitles"));
+
+	m_modeComboBox->addItem(tr("Shift by offset"));
+	m_modeComboBox->addItem(tr("Multiply by factor"));
+	m_modeComboBox->addItem(tr("Convert frame rate"));
+	m_modeComboBox->addItem(tr("Fit to two anchor points"));
+
+	m_scopeComboBox->addItem(tr("All tracks"), AllTracksScope);
+	m_scopeComboBox->addItem(tr("Current track"), TrackScope);
+	m_scopeComboBox->addItem(tr("Current track from current subtitle"), FollowingScope);
+
+	if (selection)
+	{
+		m_scopeComboBox->addItem(tr("Selected subtitles"), SelectionScope);
+		m_scopeComboBox->setCurrentIndex(m_scopeComboBox->count() - 1);
+	}
+
+	m_offsetSpinBox->setRange(-86400000, 86400000);
+	m_offsetSpinBox->setSingleStep(100);
+	m_offsetSpinBox->setSuffix(tr(" ms"));
+
+	m_scaleSpinBox->setDecimals(5);
+	m_scaleSpinBox->setRange(0.001, 100);
+	m_scaleSpinBox->setSingleStep(0.001);
+	m_scaleSpinBox->setValue(1);
+
+	QWidget *shiftPage = new QWidget(m_stackedWidget);
+	QFormLayout *shiftLayout = new QFormLayout(shiftPage);
+	shiftLayout->addRow(tr("Offset:"), m_offsetSpinBox);
+
+	QWidget *rescalePage = new QWidget(m_stackedWidget);
+	QFormLayout *rescaleLayout = new QFormLayout(rescalePage);
+	rescaleLayout->addRow(tr("Time multiplier:"), m_scaleSpinBox);
+
+	QWidget *frameRatePage = new QWidget(m_stackedWidget);
+	QFormLayout *frameRateLayout = new QFormLayout(frameRatePage);
+	frameRateLayout->addRow(tr("Source frame rate:"), m_sourceRateSpinBox);
+	frameRateLayout->addRow(tr("Target frame rate:"), m_targetRateSpinBox);
+
+	QWidget *fitPage = new QWidget(m_stackedWidget);
+	QFormLayout *fitLayout = new QFormLayout(fitPage);
+	fitLayout->addRow(tr("First anchor, current time:"), m_firstSourceTimeEdit);
+	fitLayout->addRow(tr("First anchor, correct time:"), m_firstTargetTimeEdit);
+	fitLayout->addRow(tr("Second anchor, current time:"), m_secondSourceTimeEdit);
+	fitLayout->addRow(tr("Second anchor, correct time:"), m_secondTargetTimeEdit);
+
+	m_stackedWidget->addWidget(shiftPage);
+	m_stackedWidget->addWidget(rescalePage);
+	m_stackedWidget->addWidget(frameRatePage);
+	m_stackedWidget->addWidget(fitPage);
+
+	QFormLayout *optionsLayout = new QFormLayout();
+	optionsLayout->addRow(tr("Operation:"), m_modeComboBox);
+	optionsLayout->addRow(tr("Apply to:"), m_scopeComboBox);
+
+	QVBoxLayout *mainLayout = new QVBoxLayout(this);
+	mainLayout->addLayout(optionsLayout);
+	mainLayout->addWidget(m_stackedWidget);
+	mainLayout->addWidget(m_buttonBox);
+
+	connect(m_modeComboBox, SIGNAL(currentIndexChanged(int)), m_stackedWidget, SLOT(setCurrentIndex(int)));
+	connect(m_modeComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(updateState()));
+	connect(m_offsetSpinBox, SIGNAL(valueChanged(int)), this, SLOT(updateState()));
+	connect(m_scaleSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateState()));
+	connect(m_sourceRateSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateState()));
+	connect(m_targetRateSpinBox, SIGNAL(valueChanged(double)), this, SLOT(updateState()));
+	connect(m_firstSourceTimeEdit, SIGNAL(valueChanged(int)), this, SLOT(updateState()));
+	connect(m_firstTargetTimeEdit, SIGNAL(valueChanged(int)), this, SLOT(updateState()));
+	connect(m_secondSourceTimeEdit, SIGNAL(valueChanged(int)), this, SLOT(updateState()));
+	connect(m_secondTargetTimeEdit, SIGNAL(valueChanged(int)), this, SLOT(updateState()));
+	connect(m_buttonBox, SIGNAL(accepted()), this, SLOT(accept()));
+	connect(m_buttonBox, SIGNAL(rejected()), this, SLOT(reject()));
+
+	updateState();
+}
+
+void RetimeDialog::setAnchor(qint64 source, qint64 target)
+{
+	m_firstSourceTimeEdit->setTime(source);
+	m_firstTargetTimeEdit->setTime(target);
+}
+
+void RetimeDialog::updateState()
+{
+	const SubtitlesRetimer currentRetimer = retimer();
+
+	m_buttonBox->button(QDialogButtonBox::Ok)->setEnabled(currentRetimer.isValid() && !currentRetimer.isIdentity());
+}
+
+SubtitlesRetimer RetimeDialog::retimer() const
+{
+	switch (m_modeComboBox->currentIndex())
+	{
+		case ShiftMode:
+			return SubtitlesRetimer::shift(m_offsetSpinBox->value());
+		case RescaleMode:
+			return SubtitlesRetimer::rescale(m_scaleSpinBox->value());
+		case FrameRateMode:
+			return SubtitlesRetimer::convertFrameRate(m_sourceRateSpinBox->value(), m_targetRateSpinBox->value());
+		case FitMode:
+			return SubtitlesRetimer::fit(m_firstSourceTimeEdit->time(), m_firstTargetTimeEdit->time(), m_secondSourceTimeEdit->time(), m_secondTargetTimeEdit->time());
+		default:
+			break;
+	}
+
+	return SubtitlesRetimer();
+}
+
+RetimeDialog::Scope RetimeDialog::scope() const
+{
+	return static_cast<Scope>(m_scopeComboBox->itemData(m_scopeComboBox->currentIndex()).toInt());
+}
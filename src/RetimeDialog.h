@@ -0,0 +1,82 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef RETIMEDIALOG_H
+#define RETIMEDIALOG_H
+
+#include "SubtitlesRetimer.h"
+
+#include <QtWidgets/QDialog>
+
+class QComboBox;
+class QDialogButtonBox;
+class QDoubleSpinBox;
+class QSpinBox;
+class QStackedWidget;
+
+class TimeSpinBox;
+
+class RetimeDialog : public QDialog
+{
+	Q_OBJECT
+
+public:
+	enum Mode
+	{
+		ShiftMode = 0,
+		RescaleMode,
+		FrameRateMode,
+		FitMode
+	};
+
+	enum Scope
+	{
+		AllTracksScope = 0,
+		TrackScope,
+		FollowingScope,
+		SelectionScope
+	};
+
+	explicit RetimeDialog(bool selection, QWidget *parent = NULL);
+
+	void setAnchor(qint64 source, qint64 target);
+	SubtitlesRetimer retimer() const;
+	Scope scope() const;
+
+protected slots:
+	void updateState();
+
+private:
+	QComboBox *m_modeComboBox;
+	QComboBox *m_scopeComboBox;
+	QStackedWidget *m_stackedWidget;
+	QSpinBox *m_offsetSpinBox;
+	QDoubleSpinBox *m_scaleSpinBox;
+	QDoubleSpinBox *m_sourceRateSpinBox;
+	QDoubleSpinBox *m_targetRateSpinBox;
+	TimeSpinBox *m_firstSourceTimeEdit;
+	TimeSpinBox *m_firstTargetTimeEdit;
+	TimeSpinBox *m_secondSourceTimeEdit;
+	TimeSpinBox *m_secondTargetTimeEdit;
+	QDialogButtonBox *m_buttonBox;
+};
+
+#endif
@@ -0,0 +1,118 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SearchBrowser.h"
+#include "SequencesCatalog.h"
+#include "SubtitlesWriter.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtWidgets/QHeaderView>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QLineEdit>
+#include <QtWidgets/QTreeWidget>
+#include <QtWidgets/QVBoxLayout>
+
+SearchBrowser::SearchBrowser(QWidget *parent) : QWidget(parent),
+	m_treeWidget(new QTreeWidget(this)),
+	m_queryLineEdit(new QLineEdit(this)),
+	m_statusLabel(new QLabel(this))
+{
+	m_queryLineEdit->setPlaceholderText(tr("Search in all sequences"));
+	m_queryLineEdit->setClearButtonEnabled(true);
+
+	m_treeWidget->setRootIsDecorated(false);
+	m_treeWidget->setUniformRowHeights(true);
+	m_treeWidget->setHeaderLabels(QStringList() << tr("Sequence") << tr("Track") << tr("Time") << tr("Text"));
+	m_treeWidget->header()->setSectionResizeMode(3, QHeaderView::Stretch);
+	m_treeWidget->header()->setStretchLastSection(false);
+
+	QVBoxLayout *mainLayout = new QVBoxLayout(this);
+	mainLayout->setContentsMargins(0, 0, 0, 0);
+	mainLayout->setSpacing(0);
+	mainLayout->addWidget(m_queryLineEdit);
+	mainLayout->addWidget(m_treeWidget);
+	mainLayout->addWidget(m_statusLabel);
+
+	connect(m_queryLineEdit, SIGNAL(textChanged(QString)), this, SLOT(search()));
+	connect(m_treeWidget, SIGNAL(itemActivated(QTreeWidgetItem*,int)), this, SLOT(activateHit(QTreeWidgetItem*)));
+}
+
+void SearchBrowser::setIndex(const SearchIndex &index)
+{
+	m_index = index;
+
+	search();
+}
+
+void SearchBrowser::search()
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	const QList<SearchHit> hits = m_index.search(m_queryLineEdit->text());
+	const qint64 elapsed = timer.elapsed();
+	const QDir directory(m_index.root());
+	QList<QTreeWidgetItem*> items;
+	char buffer[32];
+
+	items.reserve(hits.count());
+
+	for (int i = 0; i < hits.count(); ++i)
+	{
+		const QString language = SequencesCatalog::trackLanguage(hits.at(i).fileName);
+		const QString placement = (hits.at(i).fileName.endsWith(".txa", Qt::CaseInsensitive) ? tr("Top") : tr("Bottom"));
+		QTreeWidgetItem *item = new QTreeWidgetItem();
+		item->setText(0, directory.relativeFilePath(SequencesCatalog::sequencePath(hits.at(i).fileName)));
+		item->setText(1, (language.isEmpty() ? placement : QString("%1 (%2)").arg(placement).arg(language)));
+		item->setText(2, QString::fromLatin1(buffer, SubtitlesWriter::formatTime(hits.at(i).begin, buffer, true)));
+		item->setText(3, QString(hits.at(i).text).replace('\n', ' '));
+		item->setToolTip(3, hits.at(i).text);
+		item->setData(0, Qt::UserRole, hits.at(i).fileName);
+		item->setData(1, Qt::UserRole, hits.at(i).track);
+		item->setData(2, Qt::UserRole, hits.at(i).begin);
+		item->setData(3, Qt::UserRole, hits.at(i).subtitle);
+
+		items.append(item);
+	}
+
+	m_treeWidget->setUpdatesEnabled(false);
+	m_treeWidget->clear();
+	m_treeWidget->addTopLevelItems(items);
+	m_treeWidget->setUpdatesEnabled(true);
+
+	if (m_queryLineEdit->text().isEmpty())
+	{
+		m_statusLabel->setText(tr("%n indexed term(s)", "", m_index.tokenCount()));
+	}
+	else
+	{
+		m_statusLabel->setText(tr("%n hit(s) in %1 ms", "", hits.count()).arg(elapsed));
+	}
+}
+
+void SearchBrowser::activateHit(QTreeWidgetItem *item)
+{
+	if (item)
+	{
+		emit hitActivated(item->data(0, Qt::UserRole).toString(), item->data(1, Qt::UserRole).toInt(), item->data(3, Qt::UserRole).toInt(), item->data(2, Qt::UserRole).toLongLong());
+	}
+}
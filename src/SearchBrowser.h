@@ -0,0 +1,60 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SEARCHBROWSER_H
+#define SEARCHBROWSER_H
+
+#include "SearchIndex.h"
+
+#include <QtWidgets/QWidget>
+
+class QLabel;
+class QLineEdit;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+class SearchBrowser : public QWidget
+{
+	Q_OBJECT
+
+public:
+	explicit SearchBrowser(QWidget *parent = NULL);
+
+	void setIndex(const SearchIndex &index);
+
+public slots:
+	void search();
+
+protected slots:
+	void activateHit(QTreeWidgetItem *item);
+
+private:
+	QTreeWidget *m_treeWidget;
+	QLineEdit *m_queryLineEdit;
+	QLabel *m_statusLabel;
+	SearchIndex m_index;
+
+signals:
+	void hitActivated(QString fileName, int track, int subtitle, qint64 begin);
+
+};
+
+#endif
@@ -0,0 +1,492 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SearchIndex.h"
+#include "SubtitlesParser.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QStandardPaths>
+
+#include <algorithm>
+
+static const quint32 indexMagic = 0x575A5349;
+static const quint32 indexVersion = 1;
+
+static qint64 modificationTime(const QString &fileName)
+{
+	const QFileInfo fileInfo(fileName);
+
+	return (fileInfo.exists() ? fileInfo.lastModified().toMSecsSinceEpoch() : 0);
+}
+
+static quint64 postingKey(int document, int subtitle)
+{
+	return ((quint64(document) << 32) | quint32(subtitle));
+}
+
+static bool containsPhrase(const QStringList &tokens, const QStringList &phrase, bool prefix)
+{
+	for (int i = 0; i <= (tokens.count() - phrase.count()); ++i)
+	{
+		bool matches = true;
+
+		for (int j = 0; j < phrase.count() && matches; ++j)
+		{
+			matches = ((prefix && j == (phrase.count() - 1)) ? tokens.at(i + j).startsWith(phrase.at(j)) : (tokens.at(i + j) == phrase.at(j)));
+		}
+
+		if (matches)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+SearchIndex::SearchIndex(const QString &root) : m_root(root),
+	m_tokensValid(false),
+	m_removedDocuments(0),
+	m_modified(false)
+{
+}
+
+bool SearchIndex::load()
+{
+	QFile file(indexPath(m_root));
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic = 0;
+	quint32 version = 0;
+	QString root;
+	qint32 count = 0;
+
+	stream >> magic >> version >> root >> count;
+
+	if (magic != indexMagic || version != indexVersion || root != m_root || count < 0)
+	{
+		return false;
+	}
+
+	QVector<Document> documents;
+	documents.reserve(count);
+
+	for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+	{
+		Document document;
+		qint32 track = 0;
+
+		stream >> document.fileName >> track >> document.modified >> document.begins >> document.texts;
+
+		document.track = track;
+
+		documents.append(document);
+	}
+
+	QHash<QString, QVector<quint64> > postings;
+
+	stream >> postings;
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		return false;
+	}
+
+	m_documents = documents;
+	m_documentIndexes.clear();
+	m_postings = postings;
+	m_tokensValid = false;
+	m_removedDocuments = 0;
+	m_modified = false;
+
+	for (int i = 0; i < m_documents.count(); ++i)
+	{
+		if (m_documents.at(i).fileName.isEmpty())
+		{
+			++m_removedDocuments;
+		}
+		else
+		{
+			m_documentIndexes[m_documents.at(i).fileName] = i;
+		}
+	}
+
+	return true;
+}
+
+bool SearchIndex::save() const
+{
+	const QString path = indexPath(m_root);
+
+	QDir().mkpath(QFileInfo(path).absolutePath());
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << indexMagic << indexVersion << m_root << qint32(m_documents.count());
+
+	for (int i = 0; i < m_documents.count(); ++i)
+	{
+		const Document &document = m_documents.at(i);
+
+		stream << document.fileName << qint32(document.track) << document.modified << document.begins << document.texts;
+	}
+
+	stream << m_postings;
+
+	return file.commit();
+}
+
+void SearchIndex::setDocument(const Document &document)
+{
+	removeDocument(document.fileName);
+
+	const int index = m_documents.count();
+
+	m_documents.append(document);
+	m_documentIndexes[document.fileName] = index;
+
+	for (int i = 0; i < document.texts.count(); ++i)
+	{
+		QStringList tokens = tokenize(document.texts.at(i));
+		tokens.removeDuplicates();
+
+		for (int j = 0; j < tokens.count(); ++j)
+		{
+			m_postings[tokens.at(j)].append(postingKey(index, i));
+		}
+	}
+
+	m_tokensValid = false;
+	m_modified = true;
+
+	if (m_removedDocuments > 64 && m_removedDocuments > (m_documents.count() / 2))
+	{
+		compact();
+	}
+}
+
+void SearchIndex::setTrack(const QString &fileName, int index, const SubtitlesTrack &track)
+{
+	Document document;
+	document.fileName = QFileInfo(fileName).absoluteFilePath();
+	document.track = index;
+	document.modified = modificationTime(fileName);
+	document.begins = track.beginTimes();
+
+	for (int i = 0; i < track.count(); ++i)
+	{
+		document.texts.append(track.text(i));
+	}
+
+	setDocument(document);
+}
+
+void SearchIndex::removeDocument(const QString &fileName)
+{
+	if (!m_documentIndexes.contains(fileName))
+	{
+		return;
+	}
+
+	m_documents[m_documentIndexes.take(fileName)] = Document();
+
+	++m_removedDocuments;
+
+	m_modified = true;
+}
+
+void SearchIndex::compact()
+{
+	const QVector<Document> documents = m_documents;
+
+	m_documents.clear();
+	m_documents.reserve(documents.count() - m_removedDocuments);
+	m_documentIndexes.clear();
+	m_postings.clear();
+	m_removedDocuments = 0;
+
+	for (int i = 0; i < documents.count(); ++i)
+	{
+		if (!documents.at(i).fileName.isEmpty())
+		{
+			setDocument(documents.at(i));
+		}
+	}
+
+	m_tokensValid = false;
+	m_modified = true;
+}
+
+QList<SearchHit> SearchIndex::search(const QString &query, int limit) const
+{
+	const QStringList tokens = tokenize(query);
+	QList<SearchHit> hits;
+
+	if (tokens.isEmpty())
+	{
+		return hits;
+	}
+
+	const bool prefix = query.at(query.length() - 1).isLetterOrNumber();
+	QList<QVector<quint64> > lists;
+
+	for (int i = 0; i < tokens.count(); ++i)
+	{
+		const QVector<quint64> list = postings(tokens.at(i), (prefix && i == (tokens.count() - 1)));
+
+		if (list.isEmpty())
+		{
+			return hits;
+		}
+
+		lists.append(list);
+	}
+
+	int shortest = 0;
+
+	for (int i = 1; i < lists.count(); ++i)
+	{
+		if (lists.at(i).count() < lists.at(shortest).count())
+		{
+			shortest = i;
+		}
+	}
+
+	QVector<quint64> matches = lists.at(shortest);
+
+	for (int i = 0; i < lists.count() && !matches.isEmpty(); ++i)
+	{
+		if (i == shortest)
+		{
+			continue;
+		}
+
+		QVector<quint64> intersection(qMin(matches.count(), lists.at(i).count()));
+
+		intersection.resize(std::set_intersection(matches.constBegin(), matches.constEnd(), lists.at(i).constBegin(), lists.at(i).constEnd(), intersection.begin()) - intersection.begin());
+
+		matches = intersection;
+	}
+
+	for (int i = 0; i < matches.count() && hits.count() < limit; ++i)
+	{
+		const Document &document = m_documents.at(int(matches.at(i) >> 32));
+		const int subtitle = int(matches.at(i) & 0xFFFFFFFF);
+
+		if (document.fileName.isEmpty() || (tokens.count() > 1 && !containsPhrase(tokenize(document.texts.at(subtitle)), tokens, prefix)))
+		{
+			continue;
+		}
+
+		SearchHit hit;
+		hit.fileName = document.fileName;
+		hit.text = document.texts.at(subtitle);
+		hit.track = document.track;
+		hit.subtitle = subtitle;
+		hit.begin = document.begins.value(subtitle);
+
+		hits.append(hit);
+	}
+
+	return hits;
+}
+
+QVector<quint64> SearchIndex::postings(const QString &token, bool prefix) const
+{
+	if (!prefix)
+	{
+		return m_postings.value(token);
+	}
+
+	if (!m_tokensValid)
+	{
+		m_tokens = m_postings.keys();
+		m_tokens.sort();
+		m_tokensValid = true;
+	}
+
+	QStringList::const_iterator iterator = std::lower_bound(m_tokens.constBegin(), m_tokens.constEnd(), token);
+	QVector<quint64> list;
+	int merged = 0;
+
+	while (iterator != m_tokens.constEnd() && iterator->startsWith(token))
+	{
+		list += m_postings.value(*iterator);
+
+		++iterator;
+		++merged;
+	}
+
+	if (merged > 1)
+	{
+		std::sort(list.begin(), list.end());
+
+		list.erase(std::unique(list.begin(), list.end()), list.end());
+	}
+
+	return list;
+}
+
+QString SearchIndex::root() const
+{
+	return m_root;
+}
+
+QStringList SearchIndex::fileNames() const
+{
+	return m_documentIndexes.keys();
+}
+
+int SearchIndex::tokenCount() const
+{
+	return m_postings.count();
+}
+
+bool SearchIndex::isUpToDate(const QString &fileName) const
+{
+	return (m_documentIndexes.contains(fileName) && m_documents.at(m_documentIndexes[fileName]).modified == modificationTime(fileName));
+}
+
+bool SearchIndex::isModified() const
+{
+	return m_modified;
+}
+
+SearchIndex SearchIndex::update(const SearchIndex &index, const QHash<QString, int> &tracks)
+{
+	SearchIndex updatedIndex(index);
+	const QStringList indexedFiles = index.fileNames();
+	QStringList outdatedFiles;
+
+	for (int i = 0; i < indexedFiles.count(); ++i)
+	{
+		if (!tracks.contains(indexedFiles.at(i)))
+		{
+			updatedIndex.removeDocument(indexedFiles.at(i));
+		}
+	}
+
+	for (QHash<QString, int>::const_iterator iterator = tracks.constBegin(); iterator != tracks.constEnd(); ++iterator)
+	{
+		if (!index.isUpToDate(iterator.key()) || index.m_documents.at(index.m_documentIndexes.value(iterator.key())).track != iterator.value())
+		{
+			outdatedFiles.append(iterator.key());
+		}
+	}
+
+	QList<Document> documents = QtConcurrent::blockingMapped<QList<Document> >(outdatedFiles, &SearchIndex::scanDocument);
+
+	for (int i = 0; i < documents.count(); ++i)
+	{
+		documents[i].track = tracks.value(documents.at(i).fileName);
+
+		updatedIndex.setDocument(documents.at(i));
+	}
+
+	if (updatedIndex.m_modified)
+	{
+		if (updatedIndex.m_removedDocuments > 0)
+		{
+			updatedIndex.compact();
+		}
+
+		updatedIndex.save();
+		updatedIndex.m_modified = false;
+	}
+
+	return updatedIndex;
+}
+
+SearchIndex::Document SearchIndex::scanDocument(const QString &fileName)
+{
+	SubtitlesParser parser;
+	Document document;
+	document.fileName = QFileInfo(fileName).absoluteFilePath();
+	document.modified = modificationTime(fileName);
+
+	if (!parser.parseFile(fileName))
+	{
+		return document;
+	}
+
+	const SubtitlesTrack track = parser.track();
+
+	document.begins = track.beginTimes();
+
+	for (int i = 0; i < track.count(); ++i)
+	{
+		document.texts.append(track.text(i));
+	}
+
+	return document;
+}
+
+QStringList SearchIndex::tokenize(const QString &text)
+{
+	const QString foldedText = text.toCaseFolded();
+	QStringList tokens;
+	int start = -1;
+
+	for (int i = 0; i <= foldedText.length(); ++i)
+	{
+		if (i < foldedText.length() && foldedText.at(i).isLetterOrNumber())
+		{
+			if (start < 0)
+			{
+				start = i;
+			}
+		}
+		else if (start >= 0)
+		{
+			tokens.append(foldedText.mid(start, (i - start)));
+
+			start = -1;
+		}
+	}
+
+	return tokens;
+}
+
+QString SearchIndex::indexPath(const QString &root)
+{
+	return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QString("/search/%1.dat").arg(QString(QCryptographicHash::hash(QDir(root).absolutePath().toUtf8(), QCryptographicHash::Sha1).toHex()));
+}
@@ -0,0 +1,95 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+class SubtitlesTrack;
+
+struct SearchHit
+{
+	SearchHit() : track(0),
+		subtitle(0),
+		begin(0)
+	{
+	}
+
+	QString fileName;
+	QString text;
+	int track;
+	int subtitle;
+	qint64 begin;
+};
+
+class SearchIndex
+{
+public:
+	struct Document
+	{
+		Document() : track(0),
+			modified(0)
+		{
+		}
+
+		QString fileName;
+		int track;
+		qint64 modified;
+		QVector<qint64> begins;
+		QStringList texts;
+	};
+
+	explicit SearchIndex(const QString &root = QString());
+
+	bool load();
+	bool save() const;
+	void setDocument(const Document &document);
+	void setTrack(const QString &fileName, int index, const SubtitlesTrack &track);
+	void removeDocument(const QString &fileName);
+	void compact();
+	QList<SearchHit> search(const QString &query, int limit = 1000) const;
+	QString root() const;
+	QStringList fileNames() const;
+	int tokenCount() const;
+	bool isUpToDate(const QString &fileName) const;
+	bool isModified() const;
+	static SearchIndex update(const SearchIndex &index, const QHash<QString, int> &tracks);
+	static Document scanDocument(const QString &fileName);
+	static QStringList tokenize(const QString &text);
+	static QString indexPath(const QString &root);
+
+private:
+	QVector<quint64> postings(const QString &token, bool prefix) const;
+
+	QString m_root;
+	QVector<Document> m_documents;
+	QHash<QString, int> m_documentIndexes;
+	QHash<QString, QVector<quint64> > m_postings;
+	mutable QStringList m_tokens;
+	mutable bool m_tokensValid;
+	int m_removedDocuments;
+	bool m_modified;
+};
+
+#endif
@@ -0,0 +1,127 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+
+#include "SeekScheduler.h"
+
+#include <QtCore/QTimer>
+#include <QtMultimedia/QMediaPlayer>
+
+SeekScheduler::SeekScheduler(QMediaPlayer *player, QObject *parent) : QObject(parent),
+	m_player(player),
+	m_timer(new QTimer(this)),
+	m_target(0),
+	m_pendingTarget(0),
+	m_hasPending(false),
+	m_inFlight(false)
+{
+	m_timer->setSingleShot(true);
+
+	connect(m_timer, SIGNAL(timeout()), this, SLOT(timeout()));
+	connect(m_player, SIGNAL(positionChanged(qint64)), this, SLOT(positionChanged(qint64)));
+}
+
+void SeekScheduler::seek(qint64 position)
+{
+	if (m_inFlight)
+	{
+		m_pendingTarget = position;
+		m_hasPending = true;
+
+		return;
+	}
+
+	dispatch(position);
+}
+
+void SeekScheduler::flush()
+{
+	if (m_hasPending)
+	{
+		m_hasPending = false;
+
+		dispatch(m_pendingTarget);
+	}
+}
+
+void SeekScheduler::dispatch(qint64 position)
+{
+	m_target = position;
+	m_inFlight = true;
+
+	m_elapsedTimer.start();
+	m_timer->start(SettleTimeout);
+
+	m_player->setPosition(position);
+}
+
+void SeekScheduler::complete()
+{
+	m_timer->stop();
+
+	m_inFlight = false;
+
+	if (m_hasPending)
+	{
+		m_hasPending = false;
+
+		dispatch(m_pendingTarget);
+	}
+}
+
+void SeekScheduler::positionChanged(qint64 position)
+{
+	Q_UNUSED(position)
+
+	if (!m_inFlight)
+	{
+		return;
+	}
+
+	const qint64 elapsed = m_elapsedTimer.elapsed();
+
+	if (elapsed >= MinimumInterval)
+	{
+		complete();
+	}
+	else
+	{
+		m_timer->start(int(MinimumInterval - elapsed));
+	}
+}
+
+void SeekScheduler::timeout()
+{
+	if (m_inFlight)
+	{
+		complete();
+	}
+}
+
+qint64 SeekScheduler::target() const
+{
+	return (m_hasPending ? m_pendingTarget : m_target);
+}
+
+bool SeekScheduler::isSeeking() const
+{
+	return (m_inFlight || m_hasPending);
+}
@@ -0,0 +1,71 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+
+#ifndef SEEKSCHEDULER_H
+#define SEEKSCHEDULER_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+
+class QMediaPlayer;
+class QTimer;
+
+class SeekScheduler : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum
+	{
+		MinimumInterval = 40,
+		SettleTimeout = 250
+	};
+
+	explicit SeekScheduler(QMediaPlayer *player, QObject *parent = NULL);
+
+	qint64 target() const;
+	bool isSeeking() const;
+
+public slots:
+	void seek(qint64 position);
+	void flush();
+
+protected:
+	void dispatch(qint64 position);
+	void complete();
+
+protected slots:
+	void positionChanged(qint64 position);
+	void timeout();
+
+private:
+	QMediaPlayer *m_player;
+	QTimer *m_timer;
+	QElapsedTimer m_elapsedTimer;
+	qint64 m_target;
+	qint64 m_pendingTarget;
+	bool m_hasPending;
+	bool m_inFlight;
+
+};
+
+#endif
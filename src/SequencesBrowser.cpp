@@ -0,0 +1,144 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SequencesBrowser.h"
+#include "SubtitlesWriter.h"
+
+#include <QtWidgets/QHeaderView>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QLineEdit>
+#include <QtWidgets/QToolButton>
+#include <QtWidgets/QTreeWidget>
+#include <QtWidgets/QVBoxLayout>
+
+class SequenceItem : public QTreeWidgetItem
+{
+public:
+	bool operator<(const QTreeWidgetItem &other) const
+	{
+		const int column = (treeWidget() ? treeWidget()->sortColumn() : 0);
+
+		if (data(column, Qt::UserRole).isValid())
+		{
+			return (data(column, Qt::UserRole).toLongLong() < other.data(column, Qt::UserRole).toLongLong());
+		}
+
+		return QTreeWidgetItem::operator<(other);
+	}
+};
+
+SequencesBrowser::SequencesBrowser(QWidget *parent) : QWidget(parent),
+	m_treeWidget(new QTreeWidget(this)),
+	m_filterLineEdit(new QLineEdit(this)),
+	m_statusLabel(new QLabel(tr("No directory selected"), this))
+{
+	QToolButton *rootButton = new QToolButton(this);
+	rootButton->setIcon(QIcon::fromTheme("folder-open", style()->standardIcon(QStyle::SP_DirOpenIcon)));
+	rootButton->setToolTip(tr("Choose Sequences Directory..."));
+	rootButton->setAutoRaise(true);
+
+	m_filterLineEdit->setPlaceholderText(tr("Filter"));
+
+	m_treeWidget->setRootIsDecorated(false);
+	m_treeWidget->setUniformRowHeights(true);
+	m_treeWidget->setSortingEnabled(true);
+	m_treeWidget->setHeaderLabels(QStringList() << tr("Sequence") << tr("Top") << tr("Bottom") << tr("Duration"));
+	m_treeWidget->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+	m_treeWidget->header()->setStretchLastSection(false);
+	m_treeWidget->sortByColumn(0, Qt::AscendingOrder);
+
+	QHBoxLayout *toolbarLayout = new QHBoxLayout();
+	toolbarLayout->addWidget(m_filterLineEdit);
+	toolbarLayout->addWidget(rootButton);
+
+	QVBoxLayout *mainLayout = new QVBoxLayout(this);
+	mainLayout->setContentsMargins(0, 0, 0, 0);
+	mainLayout->setSpacing(0);
+	mainLayout->addLayout(toolbarLayout);
+	mainLayout->addWidget(m_treeWidget);
+	mainLayout->addWidget(m_statusLabel);
+
+	connect(rootButton, SIGNAL(clicked()), this, SIGNAL(rootRequested()));
+	connect(m_filterLineEdit, SIGNAL(textChanged(QString)), this, SLOT(filterSequences(QString)));
+	connect(m_treeWidget, SIGNAL(itemActivated(QTreeWidgetItem*,int)), this, SLOT(activateSequence(QTreeWidgetItem*)));
+}
+
+void SequencesBrowser::setCatalog(const SequencesCatalog &catalog)
+{
+	const QList<SequenceInformation> sequences = catalog.sequences();
+	QList<QTreeWidgetItem*> items;
+	char buffer[32];
+
+	m_catalog = catalog;
+
+	items.reserve(sequences.count());
+
+	for (int i = 0; i < sequences.count(); ++i)
+	{
+		QTreeWidgetItem *item = new SequenceItem();
+		item->setText(0, sequences.at(i).name);
+		item->setData(1, Qt::DisplayRole, sequences.at(i).topSubtitles);
+		item->setData(2, Qt::DisplayRole, sequences.at(i).bottomSubtitles);
+		item->setText(3, QString::fromLatin1(buffer, SubtitlesWriter::formatTime(sequences.at(i).duration, buffer, true)));
+		item->setData(3, Qt::UserRole, sequences.at(i).duration);
+		item->setToolTip(0, catalog.fileName(sequences.at(i).name));
+
+		items.append(item);
+	}
+
+	m_treeWidget->setUpdatesEnabled(false);
+	m_treeWidget->clear();
+	m_treeWidget->addTopLevelItems(items);
+	m_treeWidget->setUpdatesEnabled(true);
+
+	m_statusLabel->setText(tr("%n sequence(s) in %1", "", sequences.count()).arg(catalog.root()));
+
+	filterSequences(m_filterLineEdit->text());
+}
+
+void SequencesBrowser::setBusy(bool busy)
+{
+	if (busy)
+	{
+		m_statusLabel->setText(tr("Indexing %1...").arg(m_catalog.root()));
+	}
+	else
+	{
+		m_statusLabel->setText(tr("%n sequence(s) in %1", "", m_treeWidget->topLevelItemCount()).arg(m_catalog.root()));
+	}
+}
+
+void SequencesBrowser::filterSequences(const QString &filter)
+{
+	for (int i = 0; i < m_treeWidget->topLevelItemCount(); ++i)
+	{
+		QTreeWidgetItem *item = m_treeWidget->topLevelItem(i);
+		item->setHidden(!filter.isEmpty() && !item->text(0).contains(filter, Qt::CaseInsensitive));
+	}
+}
+
+void SequencesBrowser::activateSequence(QTreeWidgetItem *item)
+{
+	if (item)
+	{
+		emit sequenceActivated(m_catalog.fileName(item->text(0)));
+	}
+}
@@ -0,0 +1,62 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SEQUENCESBROWSER_H
+#define SEQUENCESBROWSER_H
+
+#include "SequencesCatalog.h"
+
+#include <QtWidgets/QWidget>
+
+class QLabel;
+class QLineEdit;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+class SequencesBrowser : public QWidget
+{
+	Q_OBJECT
+
+public:
+	explicit SequencesBrowser(QWidget *parent = NULL);
+
+	void setCatalog(const SequencesCatalog &catalog);
+
+public slots:
+	void setBusy(bool busy);
+
+protected slots:
+	void filterSequences(const QString &filter);
+	void activateSequence(QTreeWidgetItem *item);
+
+private:
+	QTreeWidget *m_treeWidget;
+	QLineEdit *m_filterLineEdit;
+	QLabel *m_statusLabel;
+	SequencesCatalog m_catalog;
+
+signals:
+	void rootRequested();
+	void sequenceActivated(QString fileName);
+
+};
+
+#endif
@@ -0,0 +1,398 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SequencesCatalog.h"
+#include "SubtitlesParser.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QRegExp>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QtEndian>
+
+static const quint32 catalogMagic = 0x575A5343;
+static const quint32 catalogVersion = 1;
+
+SequencesCatalog::SequencesCatalog(const QString &root) : m_root(root)
+{
+}
+
+bool SequencesCatalog::load()
+{
+	QFile file(catalogPath(m_root));
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic = 0;
+	quint32 version = 0;
+	QString root;
+	qint32 count = 0;
+
+	stream >> magic >> version >> root >> count;
+
+	if (magic != catalogMagic || version != catalogVersion || root != m_root || count < 0)
+	{
+		return false;
+	}
+
+	m_sequences.clear();
+	m_sequences.reserve(count);
+
+	for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+	{
+		SequenceInformation sequence;
+		qint32 topSubtitles = 0;
+		qint32 bottomSubtitles = 0;
+
+		stream >> sequence.name >> sequence.mediaFile >> topSubtitles >> bottomSubtitles >> sequence.duration >> sequence.mediaModified >> sequence.topModified >> sequence.bottomModified;
+
+		sequence.topSubtitles = topSubtitles;
+		sequence.bottomSubtitles = bottomSubtitles;
+
+		m_sequences[sequence.name] = sequence;
+	}
+
+	return (stream.status() == QDataStream::Ok);
+}
+
+bool SequencesCatalog::save() const
+{
+	const QString path = catalogPath(m_root);
+
+	QDir().mkpath(QFileInfo(path).absolutePath());
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << catalogMagic << catalogVersion << m_root << qint32(m_sequences.count());
+
+	QHash<QString, SequenceInformation>::const_iterator iterator;
+
+	for (iterator = m_sequences.constBegin(); iterator != m_sequences.constEnd(); ++iterator)
+	{
+		stream << iterator->name << iterator->mediaFile << qint32(iterator->topSubtitles) << qint32(iterator->bottomSubtitles) << iterator->duration << iterator->mediaModified << iterator->topModified << iterator->bottomModified;
+	}
+
+	return file.commit();
+}
+
+void SequencesCatalog::setSequence(const SequenceInformation &sequence)
+{
+	m_sequences[sequence.name] = sequence;
+}
+
+void SequencesCatalog::setSequences(const QList<SequenceInformation> &sequences)
+{
+	m_sequences.clear();
+	m_sequences.reserve(sequences.count());
+
+	for (int i = 0; i < sequences.count(); ++i)
+	{
+		m_sequences[sequences.at(i).name] = sequences.at(i);
+	}
+}
+
+void SequencesCatalog::removeSequence(const QString &name)
+{
+	m_sequences.remove(name);
+}
+
+QString SequencesCatalog::root() const
+{
+	return m_root;
+}
+
+QString SequencesCatalog::fileName(const QString &name) const
+{
+	const SequenceInformation information = sequence(name);
+
+	if (!information.mediaFile.isEmpty())
+	{
+		return information.mediaFile;
+	}
+
+	return QDir(m_root).filePath(name + ((information.bottomModified > 0 || information.topModified == 0) ? ".txt" : ".txa"));
+}
+
+SequenceInformation SequencesCatalog::sequence(const QString &name) const
+{
+	return m_sequences.value(name);
+}
+
+QList<SequenceInformation> SequencesCatalog::sequences() const
+{
+	return m_sequences.values();
+}
+
+QStringList SequencesCatalog::names() const
+{
+	QStringList names = m_sequences.keys();
+	names.sort();
+
+	return names;
+}
+
+bool SequencesCatalog::contains(const QString &name) const
+{
+	return m_sequences.contains(name);
+}
+
+bool SequencesCatalog::isUpToDate(const QString &name) const
+{
+	if (!m_sequences.contains(name))
+	{
+		return false;
+	}
+
+	const SequenceInformation &sequence = m_sequences[name];
+	const QString path = QDir(m_root).filePath(name);
+
+	return (mediaFile(path) == sequence.mediaFile && modificationTime(sequence.mediaFile) == sequence.mediaModified && modificationTime(path + ".txa") == sequence.topModified && modificationTime(path + ".txt") == sequence.bottomModified);
+}
+
+SequenceInformation SequencesCatalog::scanSequence(const QString &root, const QString &name)
+{
+	const QString path = QDir(root).filePath(name);
+	SequenceInformation sequence;
+	sequence.name = name;
+	sequence.mediaFile = mediaFile(path);
+	sequence.mediaModified = modificationTime(sequence.mediaFile);
+	sequence.topModified = modificationTime(path + ".txa");
+	sequence.bottomModified = modificationTime(path + ".txt");
+	sequence.duration = mediaDuration(sequence.mediaFile);
+
+	const QStringList subtitleFiles = (QStringList() << (path + ".txa") << (path + ".txt"));
+
+	for (int i = 0; i < subtitleFiles.count(); ++i)
+	{
+		SubtitlesParser parser;
+
+		if (!parser.parseFile(subtitleFiles.at(i)))
+		{
+			continue;
+		}
+
+		const SubtitlesTrack track = parser.track();
+
+		if (i == 0)
+		{
+			sequence.topSubtitles = track.count();
+		}
+		else
+		{
+			sequence.bottomSubtitles = track.count();
+		}
+
+		if (sequence.mediaFile.isEmpty())
+		{
+			for (int j = 0; j < track.count(); ++j)
+			{
+				sequence.duration = qMax(sequence.duration, track.end(j));
+			}
+		}
+	}
+
+	return sequence;
+}
+
+QStringList SequencesCatalog::findSequences(const QString &root)
+{
+	QDirIterator iterator(root, (QStringList() << "*.txt" << "*.txa" << "*.ogg" << "*.ogm" << "*.ogv"), QDir::Files, QDirIterator::Subdirectories);
+	const QDir directory(root);
+	QSet<QString> names;
+
+	while (iterator.hasNext())
+	{
+		names.insert(sequencePath(directory.relativeFilePath(iterator.next())));
+	}
+
+	QStringList sequences = names.values();
+	sequences.sort();
+
+	return sequences;
+}
+
+QStringList SequencesCatalog::findTranslations(const QString &path)
+{
+	const QFileInfo fileInfo(path);
+	const QStringList entries = fileInfo.dir().entryList((QStringList() << (fileInfo.fileName() + ".*.txa") << (fileInfo.fileName() + ".*.txt")), QDir::Files, QDir::Name);
+	QStringList translations;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		const QString language = trackLanguage(entries.at(i));
+
+		if (!language.isEmpty() && entries.at(i).length() == (fileInfo.fileName().length() + language.length() + 5))
+		{
+			translations.append(fileInfo.dir().filePath(entries.at(i)));
+		}
+	}
+
+	return translations;
+}
+
+QStringList SequencesCatalog::trackFiles(const QString &path)
+{
+	return (QStringList() << (path + ".txa") << (path + ".txt") << findTranslations(path));
+}
+
+QString SequencesCatalog::catalogPath(const QString &root)
+{
+	return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QString("/catalogs/%1.dat").arg(QString(QCryptographicHash::hash(QDir(root).absolutePath().toUtf8(), QCryptographicHash::Sha1).toHex()));
+}
+
+qint64 SequencesCatalog::mediaDuration(const QString &fileName)
+{
+	QFile file(fileName);
+
+	if (fileName.isEmpty() || !file.open(QIODevice::ReadOnly))
+	{
+		return 0;
+	}
+
+	const QByteArray head = file.read(65536);
+	const int vorbis = head.indexOf(QByteArray("\x01vorbis", 7));
+
+	if (vorbis < 0 || (vorbis + 16) > head.size())
+	{
+		return 0;
+	}
+
+	const int page = head.lastIndexOf("OggS", vorbis);
+	const quint32 rate = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(head.constData() + vorbis + 12));
+
+	if (page < 0 || (page + 27) > head.size() || rate == 0)
+	{
+		return 0;
+	}
+
+	const quint32 serial = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(head.constData() + page + 14));
+	const qint64 size = file.size();
+	const qint64 tailSize = qMin(size, qint64(262144));
+
+	file.seek(size - tailSize);
+
+	const QByteArray tail = file.read(tailSize);
+	int position = tail.lastIndexOf("OggS");
+
+	while (position >= 0)
+	{
+		if ((position + 27) <= tail.size() && qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(tail.constData() + position + 14)) == serial)
+		{
+			const qint64 granule = qFromLittleEndian<qint64>(reinterpret_cast<const uchar*>(tail.constData() + position + 6));
+
+			if (granule > 0)
+			{
+				return ((granule * 1000) / rate);
+			}
+		}
+
+		if (position == 0)
+		{
+			break;
+		}
+
+		position = tail.lastIndexOf("OggS", (position - 1));
+	}
+
+	return 0;
+}
+
+qint64 SequencesCatalog::modificationTime(const QString &fileName)
+{
+	if (fileName.isEmpty())
+	{
+		return 0;
+	}
+
+	const QFileInfo fileInfo(fileName);
+
+	return (fileInfo.exists() ? fileInfo.lastModified().toMSecsSinceEpoch() : 0);
+}
+
+QByteArray SequencesCatalog::fileChecksum(const QString &fileName)
+{
+	QFile file(fileName);
+
+	if (fileName.isEmpty() || !file.open(QIODevice::ReadOnly))
+	{
+		return QByteArray();
+	}
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(&file);
+
+	return hash.result();
+}
+
+QString SequencesCatalog::trackLanguage(const QString &fileName)
+{
+	QRegExp expression("\\.([a-z]{2,3}(_[A-Z]{2})?)\\.(txa|txt)$");
+
+	return ((expression.indexIn(fileName) >= 0) ? expression.cap(1) : QString());
+}
+
+QString SequencesCatalog::sequencePath(const QString &fileName)
+{
+	const QString language = trackLanguage(fileName);
+	QString path = fileName.left(fileName.lastIndexOf('.'));
+
+	if (!language.isEmpty())
+	{
+		path.chop(language.length() + 1);
+	}
+
+	return path;
+}
+
+QString SequencesCatalog::mediaFile(const QString &path)
+{
+	const QStringList suffixes = (QStringList() << ".ogv" << ".ogm" << ".ogg");
+
+	for (int i = 0; i < suffixes.count(); ++i)
+	{
+		if (QFile::exists(path + suffixes.at(i)))
+		{
+			return (path + suffixes.at(i));
+		}
+	}
+
+	return QString();
+}
@@ -0,0 +1,83 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SEQUENCESCATALOG_H
+#define SEQUENCESCATALOG_H
+
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+
+struct SequenceInformation
+{
+	SequenceInformation() : topSubtitles(0),
+		bottomSubtitles(0),
+		duration(0),
+		mediaModified(0),
+		topModified(0),
+		bottomModified(0)
+	{
+	}
+
+	QString name;
+	QString mediaFile;
+	int topSubtitles;
+	int bottomSubtitles;
+	qint64 duration;
+	qint64 mediaModified;
+	qint64 topModified;
+	qint64 bottomModified;
+};
+
+class SequencesCatalog
+{
+public:
+	explicit SequencesCatalog(const QString &root = QString());
+
+	bool load();
+	bool save() const;
+	void setSequence(const SequenceInformation &sequence);
+	void setSequences(const QList<SequenceInformation> &sequences);
+	void removeSequence(const QString &name);
+	QString root() const;
+	QString fileName(const QString &name) const;
+	SequenceInformation sequence(const QString &name) const;
+	QList<SequenceInformation> sequences() const;
+	QStringList names() const;
+	bool contains(const QString &name) const;
+	bool isUpToDate(const QString &name) const;
+	static SequenceInformation scanSequence(const QString &root, const QString &name);
+	static QStringList findSequences(const QString &root);
+	static QStringList findTranslations(const QString &path);
+	static QStringList trackFiles(const QString &path);
+	static QString catalogPath(const QString &root);
+	static qint64 mediaDuration(const QString &fileName);
+	static qint64 modificationTime(const QString &fileName);
+	static QByteArray fileChecksum(const QString &fileName);
+	static QString mediaFile(const QString &path);
+	static QString trackLanguage(const QString &fileName);
+	static QString sequencePath(const QString &fileName);
+
+private:
+	QString m_root;
+	QHash<QString, SequenceInformation> m_sequences;
+};
+
+#endif
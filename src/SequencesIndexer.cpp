@@ -0,0 +1,258 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SequencesIndexer.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+
+struct SequenceScanner
+{
+	typedef SequenceInformation result_type;
+
+	explicit SequenceScanner(const QString &root) : m_root(root)
+	{
+	}
+
+	SequenceInformation operator()(const QString &name) const
+	{
+		return SequencesCatalog::scanSequence(m_root, name);
+	}
+
+	QString m_root;
+};
+
+SequencesIndexer::SequencesIndexer(QObject *parent) : QObject(parent),
+	m_watcher(new QFutureWatcher<SequencesCatalog>(this)),
+	m_searchWatcher(new QFutureWatcher<SearchIndex>(this))
+{
+	connect(m_watcher, SIGNAL(finished()), this, SLOT(updateFinished()));
+	connect(m_searchWatcher, SIGNAL(finished()), this, SLOT(searchUpdateFinished()));
+}
+
+void SequencesIndexer::start(const QString &root)
+{
+	if (isRunning())
+	{
+		m_pendingRoot = root;
+
+		return;
+	}
+
+	if (root != m_catalog.root())
+	{
+		m_pendingTracks.clear();
+		m_pendingSequences.clear();
+
+		m_catalog = SequencesCatalog(root);
+		m_catalog.load();
+
+		m_searchIndex = SearchIndex(root);
+		m_searchIndex.load();
+
+		emit catalogChanged();
+		emit searchIndexChanged();
+	}
+
+	m_watcher->setFuture(QtConcurrent::run(&SequencesIndexer::update, m_catalog));
+
+	emit runningChanged(true);
+}
+
+void SequencesIndexer::updateSequence(const QString &path)
+{
+	const QString name = QDir(m_catalog.root()).relativeFilePath(path);
+
+	if (m_catalog.root().isEmpty() || name.startsWith(".."))
+	{
+		return;
+	}
+
+	if (m_watcher->isRunning())
+	{
+		if (!m_pendingSequences.contains(name))
+		{
+			m_pendingSequences.append(name);
+		}
+
+		return;
+	}
+
+	rescanSequence(name);
+	m_catalog.save();
+
+	emit catalogChanged();
+}
+
+void SequencesIndexer::updateTrack(const QString &fileName, int index, const SubtitlesTrack &track)
+{
+	if (m_searchIndex.root().isEmpty() || QDir(m_searchIndex.root()).relativeFilePath(fileName).startsWith(".."))
+	{
+		return;
+	}
+
+	if (m_searchWatcher->isRunning())
+	{
+		m_pendingTracks[fileName] = qMakePair(index, track);
+
+		return;
+	}
+
+	m_searchIndex.setTrack(fileName, index, track);
+
+	emit searchIndexChanged();
+}
+
+void SequencesIndexer::updateFinished()
+{
+	m_catalog = m_watcher->result();
+
+	if (!m_pendingSequences.isEmpty())
+	{
+		for (int i = 0; i < m_pendingSequences.count(); ++i)
+		{
+			rescanSequence(m_pendingSequences.at(i));
+		}
+
+		m_pendingSequences.clear();
+		m_catalog.save();
+	}
+
+	emit catalogChanged();
+
+	m_searchWatcher->setFuture(QtConcurrent::run(&SequencesIndexer::updateSearch, m_searchIndex, m_catalog));
+}
+
+void SequencesIndexer::searchUpdateFinished()
+{
+	m_searchIndex = m_searchWatcher->result();
+
+	QHash<QString, QPair<int, SubtitlesTrack> >::const_iterator iterator;
+
+	for (iterator = m_pendingTracks.constBegin(); iterator != m_pendingTracks.constEnd(); ++iterator)
+	{
+		m_searchIndex.setTrack(iterator.key(), iterator.value().first, iterator.value().second);
+	}
+
+	m_pendingTracks.clear();
+
+	emit searchIndexChanged();
+
+	if (!m_pendingRoot.isEmpty())
+	{
+		const QString root = m_pendingRoot;
+
+		m_pendingRoot.clear();
+
+		start(root);
+
+		return;
+	}
+
+	emit runningChanged(false);
+}
+
+void SequencesIndexer::rescanSequence(const QString &name)
+{
+	const SequenceInformation sequence = SequencesCatalog::scanSequence(m_catalog.root(), name);
+
+	if (sequence.mediaFile.isEmpty() && sequence.topModified == 0 && sequence.bottomModified == 0)
+	{
+		m_catalog.removeSequence(name);
+	}
+	else
+	{
+		m_catalog.setSequence(sequence);
+	}
+}
+
+SequencesCatalog SequencesIndexer::catalog() const
+{
+	return m_catalog;
+}
+
+SearchIndex SequencesIndexer::searchIndex() const
+{
+	return m_searchIndex;
+}
+
+bool SequencesIndexer::isRunning() const
+{
+	return (m_watcher->isRunning() || m_searchWatcher->isRunning());
+}
+
+SequencesCatalog SequencesIndexer::update(const SequencesCatalog &catalog)
+{
+	const QStringList names = SequencesCatalog::findSequences(catalog.root());
+	QStringList outdatedNames;
+	QList<SequenceInformation> sequences;
+
+	for (int i = 0; i < names.count(); ++i)
+	{
+		if (catalog.isUpToDate(names.at(i)))
+		{
+			sequences.append(catalog.sequence(names.at(i)));
+		}
+		else
+		{
+			outdatedNames.append(names.at(i));
+		}
+	}
+
+	if (outdatedNames.isEmpty() && sequences.count() == catalog.names().count())
+	{
+		return catalog;
+	}
+
+	sequences.append(QtConcurrent::blockingMapped<QList<SequenceInformation> >(outdatedNames, SequenceScanner(catalog.root())));
+
+	SequencesCatalog updatedCatalog(catalog.root());
+	updatedCatalog.setSequences(sequences);
+	updatedCatalog.save();
+
+	return updatedCatalog;
+}
+
+SearchIndex SequencesIndexer::updateSearch(const SearchIndex &index, const SequencesCatalog &catalog)
+{
+	const QStringList names = catalog.names();
+	const QDir directory(catalog.root());
+	QHash<QString, int> tracks;
+
+	for (int i = 0; i < names.count(); ++i)
+	{
+		const QStringList trackFiles = SequencesCatalog::trackFiles(directory.filePath(names.at(i)));
+
+		for (int j = 0; j < trackFiles.count(); ++j)
+		{
+			const QFileInfo fileInfo(trackFiles.at(j));
+
+			if (fileInfo.exists())
+			{
+				tracks[fileInfo.absoluteFilePath()] = j;
+			}
+		}
+	}
+
+	return SearchIndex::update(index, tracks);
+}
@@ -0,0 +1,72 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SEQUENCESINDEXER_H
+#define SEQUENCESINDEXER_H
+
+#include "SearchIndex.h"
+#include "SequencesCatalog.h"
+#include "SubtitlesTrack.h"
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QObject>
+#include <QtCore/QPair>
+
+class SequencesIndexer : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit SequencesIndexer(QObject *parent = NULL);
+
+	void start(const QString &root);
+	void updateSequence(const QString &path);
+	void updateTrack(const QString &fileName, int index, const SubtitlesTrack &track);
+	SequencesCatalog catalog() const;
+	SearchIndex searchIndex() const;
+	bool isRunning() const;
+	static SequencesCatalog update(const SequencesCatalog &catalog);
+	static SearchIndex updateSearch(const SearchIndex &index, const SequencesCatalog &catalog);
+
+protected:
+	void rescanSequence(const QString &name);
+
+protected slots:
+	void updateFinished();
+	void searchUpdateFinished();
+
+private:
+	QFutureWatcher<SequencesCatalog> *m_watcher;
+	QFutureWatcher<SearchIndex> *m_searchWatcher;
+	SequencesCatalog m_catalog;
+	SearchIndex m_searchIndex;
+	QHash<QString, QPair<int, SubtitlesTrack> > m_pendingTracks;
+	QStringList m_pendingSequences;
+	QString m_pendingRoot;
+
+signals:
+	void catalogChanged();
+	void searchIndexChanged();
+	void runningChanged(bool running);
+
+};
+
+#endif
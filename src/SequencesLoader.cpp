@@ -0,0 +1,229 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SequencesLoader.h"
+#include "SequencesCatalog.h"
+#include "SubtitlesBinary.h"
+#include "SubtitlesParser.h"
+#include "SubtitlesTrace.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QFile>
+
+SequencesLoader::SequencesLoader(QObject *parent) : QObject(parent),
+	m_probeWatcher(NULL),
+	m_tracksWatcher(NULL)
+{
+}
+
+void SequencesLoader::load(const QString &path)
+{
+	cancel();
+
+	m_path = path;
+	m_probeWatcher = new QFutureWatcher<QStringList>(this);
+
+	connect(m_probeWatcher, SIGNAL(finished()), this, SLOT(probeFinished()));
+
+	m_probeWatcher->setFuture(QtConcurrent::run(&SequencesLoader::probe, path));
+
+	emit progressChanged(0, 3);
+}
+
+void SequencesLoader::cancel()
+{
+	if (m_probeWatcher)
+	{
+		m_probeWatcher->disconnect(this);
+		m_probeWatcher->cancel();
+		m_probeWatcher->deleteLater();
+		m_probeWatcher = NULL;
+	}
+
+	if (m_tracksWatcher)
+	{
+		m_tracksWatcher->disconnect(this);
+		m_tracksWatcher->cancel();
+		m_tracksWatcher->deleteLater();
+		m_tracksWatcher = NULL;
+	}
+
+	if (!m_path.isEmpty())
+	{
+		m_path.clear();
+
+		emit progressChanged(0, 0);
+	}
+}
+
+void SequencesLoader::probeFinished()
+{
+	const QStringList files = m_probeWatcher->result();
+
+	m_probeWatcher->deleteLater();
+	m_probeWatcher = NULL;
+
+	if (files.isEmpty())
+	{
+		const QString path = m_path;
+
+		m_path.clear();
+
+		emit progressChanged(0, 0);
+		emit failed(path);
+
+		return;
+	}
+
+	m_tracksWatcher = new QFutureWatcher<LoadedTrack>(this);
+
+	connect(m_tracksWatcher, SIGNAL(progressValueChanged(int)), this, SLOT(updateProgress(int)));
+	connect(m_tracksWatcher, SIGNAL(finished()), this, SLOT(tracksFinished()));
+
+	m_mediaFile = files.first();
+	m_translations = files.mid(3);
+	m_tracksWatcher->setFuture(QtConcurrent::mapped(files.mid(1, 2), &SequencesLoader::loadTrack));
+
+	emit progressChanged(1, 3);
+}
+
+void SequencesLoader::tracksFinished()
+{
+	const QString path = m_path;
+	const QString mediaFile = m_mediaFile;
+	QList<LoadedTrack> tracks = m_tracksWatcher->future().results();
+
+	for (int i = 0; i < m_translations.count(); ++i)
+	{
+		tracks.append(describeTrack(m_translations.at(i)));
+	}
+
+	for (int i = 0; i < tracks.count(); ++i)
+	{
+		tracks[i].index = i;
+	}
+
+	m_translations.clear();
+	m_mediaFile.clear();
+	m_tracksWatcher->deleteLater();
+	m_tracksWatcher = NULL;
+	m_path.clear();
+
+	emit progressChanged(0, 0);
+	emit loaded(path, mediaFile, tracks);
+}
+
+void SequencesLoader::updateProgress(int value)
+{
+	emit progressChanged((value + 1), 3);
+}
+
+QString SequencesLoader::path() const
+{
+	return m_path;
+}
+
+bool SequencesLoader::isLoading() const
+{
+	return !m_path.isEmpty();
+}
+
+QStringList SequencesLoader::probe(const QString &path)
+{
+	SUBTITLES_TRACE("SequencesLoader::probe");
+
+	const QString mediaFile = SequencesCatalog::mediaFile(path);
+	const QStringList trackFiles = SequencesCatalog::trackFiles(path);
+
+	if (mediaFile.isEmpty() && !QFile::exists(trackFiles.at(0)) && !QFile::exists(trackFiles.at(1)) && trackFiles.count() == 2)
+	{
+		return QStringList();
+	}
+
+	return (QStringList() << mediaFile << trackFiles);
+}
+
+LoadedTrack SequencesLoader::describeTrack(const QString &fileName)
+{
+	LoadedTrack result;
+	result.fileName = fileName;
+	result.language = SequencesCatalog::trackLanguage(fileName);
+	result.placement = (fileName.endsWith(".txa", Qt::CaseInsensitive) ? TopPlacement : BottomPlacement);
+
+	return result;
+}
+
+LoadedTrack SequencesLoader::loadTrack(const QString &fileName)
+{
+	SUBTITLES_TRACE("SequencesLoader::loadTrack");
+
+	LoadedTrack result = describeTrack(fileName);
+	result.loaded = true;
+
+	if (!QFile::exists(fileName))
+	{
+		result.readable = true;
+
+		return result;
+	}
+
+	const QString compiledFileName = SubtitlesBinary::compiledFileName(fileName);
+
+	SubtitlesParser parser;
+
+	if (SequencesCatalog::modificationTime(compiledFileName) > SequencesCatalog::modificationTime(fileName))
+	{
+		QFile file(fileName);
+
+		if (!file.open(QIODevice::ReadOnly))
+		{
+			return result;
+		}
+
+		const QByteArray source = file.readAll();
+		SubtitlesBinary binary;
+
+		if (binary.open(compiledFileName) && binary.isOrdered() && binary.matchesSource(source))
+		{
+			result.track = binary.track();
+			result.readable = true;
+
+			return result;
+		}
+
+		parser.parse(source.constData(), source.size());
+	}
+	else if (!parser.parseFile(fileName))
+	{
+		return result;
+	}
+
+	result.track = parser.track();
+	result.readable = true;
+
+	if (!parser.errors().isEmpty())
+	{
+		result.errorString = parser.errorString();
+	}
+
+	return result;
+}
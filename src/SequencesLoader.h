@@ -0,0 +1,110 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SEQUENCESLOADER_H
+#define SEQUENCESLOADER_H
+
+#include "SubtitlesTrack.h"
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+
+enum TrackPlacement
+{
+	TopPlacement = 0,
+	BottomPlacement
+};
+
+struct TrackInformation
+{
+	TrackInformation() : placement(BottomPlacement),
+		modified(0),
+		lastViewed(0),
+		loaded(false)
+	{
+	}
+
+	QString fileName;
+	QString language;
+	QByteArray checksum;
+	TrackPlacement placement;
+	qint64 modified;
+	int lastViewed;
+	bool loaded;
+};
+
+struct LoadedTrack
+{
+	LoadedTrack() : placement(BottomPlacement),
+		index(0),
+		loaded(false),
+		readable(false)
+	{
+	}
+
+	QString fileName;
+	QString language;
+	QString errorString;
+	SubtitlesTrack track;
+	TrackPlacement placement;
+	int index;
+	bool loaded;
+	bool readable;
+};
+
+class SequencesLoader : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit SequencesLoader(QObject *parent = NULL);
+
+	void load(const QString &path);
+	QString path() const;
+	bool isLoading() const;
+	static QStringList probe(const QString &path);
+	static LoadedTrack describeTrack(const QString &fileName);
+	static LoadedTrack loadTrack(const QString &fileName);
+
+public slots:
+	void cancel();
+
+protected slots:
+	void probeFinished();
+	void tracksFinished();
+	void updateProgress(int value);
+
+private:
+	QFutureWatcher<QStringList> *m_probeWatcher;
+	QFutureWatcher<LoadedTrack> *m_tracksWatcher;
+	QStringList m_translations;
+	QString m_mediaFile;
+	QString m_path;
+
+signals:
+	void progressChanged(int value, int maximum);
+	void loaded(QString path, QString mediaFile, QList<LoadedTrack> tracks);
+	void failed(QString path);
+
+};
+
+#endif
@@ -0,0 +1,396 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SpeechDetector.h"
+#include "WaveformPeaks.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include <algorithm>
+#include <cmath>
+
+static const quint32 speechMagic = 0x575A5344;
+static const quint32 speechVersion = 1;
+
+static qint64 nearestBoundary(const QVector<qint64> &boundaries, qint64 time, qint64 tolerance)
+{
+	QVector<qint64>::const_iterator iterator = std::lower_bound(boundaries.constBegin(), boundaries.constEnd(), time);
+	qint64 nearest = time;
+	qint64 distance = (tolerance + 1);
+
+	if (iterator != boundaries.constEnd() && (*iterator - time) < distance)
+	{
+		nearest = *iterator;
+		distance = (*iterator - time);
+	}
+
+	if (iterator != boundaries.constBegin() && (time - *(iterator - 1)) < distance)
+	{
+		nearest = *(iterator - 1);
+	}
+
+	return nearest;
+}
+
+SpeechDetector::SpeechDetector() : m_pendingEnergy(0),
+	m_pendingCrossings(0),
+	m_pendingFrames(0),
+	m_windowFrames(0),
+	m_sampleRate(0),
+	m_previousSample(0)
+{
+}
+
+void SpeechDetector::clear()
+{
+	m_energies.clear();
+	m_crossingRates.clear();
+	m_pendingEnergy = 0;
+	m_pendingCrossings = 0;
+	m_pendingFrames = 0;
+	m_previousSample = 0;
+}
+
+void SpeechDetector::setSampleRate(int rate)
+{
+	m_sampleRate = rate;
+	m_windowFrames = qMax(1, ((rate * WindowLength) / 1000));
+}
+
+void SpeechDetector::appendSamples(const qint16 *samples, int frames, int channels)
+{
+	if (m_windowFrames <= 0 || channels <= 0 || frames <= 0)
+	{
+		return;
+	}
+
+	if (channels == 1)
+	{
+		analyze(samples, frames);
+
+		return;
+	}
+
+	m_mixed.resize(frames);
+
+	qint16 *mixed = m_mixed.data();
+
+	for (int i = 0; i < frames; ++i)
+	{
+		int sum = 0;
+
+		for (int j = 0; j < channels; ++j)
+		{
+			sum += samples[(i * channels) + j];
+		}
+
+		mixed[i] = qint16(sum / channels);
+	}
+
+	analyze(mixed, frames);
+}
+
+void SpeechDetector::analyze(const qint16 *samples, int count)
+{
+	int offset = 0;
+
+	while (offset < count)
+	{
+		const int length = qMin((count - offset), (m_windowFrames - m_pendingFrames));
+		const qint16 *data = (samples + offset);
+		float energies[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		int crossings = ((int(data[0]) ^ int(m_previousSample)) < 0);
+		int i = 0;
+
+		for (; (i + 8) <= length; i += 8)
+		{
+			for (int j = 0; j < 8; ++j)
+			{
+				energies[j] += (float(data[i + j]) * data[i + j]);
+			}
+		}
+
+		for (; i < length; ++i)
+		{
+			energies[0] += (float(data[i]) * data[i]);
+		}
+
+		for (i = 1; i < length; ++i)
+		{
+			crossings += ((int(data[i]) ^ int(data[i - 1])) < 0);
+		}
+
+		for (int j = 0; j < 8; ++j)
+		{
+			m_pendingEnergy += energies[j];
+		}
+
+		m_pendingCrossings += crossings;
+		m_pendingFrames += length;
+		m_previousSample = data[length - 1];
+
+		offset += length;
+
+		if (m_pendingFrames == m_windowFrames)
+		{
+			m_energies.append(m_pendingEnergy / m_windowFrames);
+			m_crossingRates.append(float(m_pendingCrossings) / m_windowFrames);
+
+			m_pendingEnergy = 0;
+			m_pendingCrossings = 0;
+			m_pendingFrames = 0;
+		}
+	}
+}
+
+void SpeechDetector::finish()
+{
+	if (m_pendingFrames > 0)
+	{
+		m_energies.append(m_pendingEnergy / m_pendingFrames);
+		m_crossingRates.append(float(m_pendingCrossings) / m_pendingFrames);
+
+		m_pendingEnergy = 0;
+		m_pendingCrossings = 0;
+		m_pendingFrames = 0;
+	}
+}
+
+bool SpeechDetector::load(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic = 0;
+	quint32 version = 0;
+	qint32 sampleRate = 0;
+	QVector<float> energies;
+	QVector<float> crossingRates;
+
+	stream >> magic >> version;
+
+	if (magic != speechMagic || version != speechVersion)
+	{
+		return false;
+	}
+
+	stream >> sampleRate >> energies >> crossingRates;
+
+	if (stream.status() != QDataStream::Ok || sampleRate <= 0 || energies.count() != crossingRates.count())
+	{
+		return false;
+	}
+
+	clear();
+	setSampleRate(sampleRate);
+
+	m_energies = energies;
+	m_crossingRates = crossingRates;
+
+	return true;
+}
+
+bool SpeechDetector::save(const QString &path) const
+{
+	QDir().mkpath(QFileInfo(path).absolutePath());
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << speechMagic << speechVersion << qint32(m_sampleRate) << m_energies << m_crossingRates;
+
+	return file.commit();
+}
+
+QVector<SpeechSegment> SpeechDetector::detect() const
+{
+	QVector<SpeechSegment> segments;
+	const int count = m_energies.count();
+
+	if (count == 0)
+	{
+		return segments;
+	}
+
+	QVector<float> levels(count);
+
+	for (int i = 0; i < count; ++i)
+	{
+		levels[i] = (10 * std::log10(m_energies.at(i) + 1.0f));
+	}
+
+	QVector<float> sortedLevels(levels);
+
+	std::nth_element(sortedLevels.begin(), (sortedLevels.begin() + (count / 10)), sortedLevels.end());
+
+	const float floor = sortedLevels.at(count / 10);
+
+	std::nth_element(sortedLevels.begin(), (sortedLevels.begin() + ((count * 95) / 100)), sortedLevels.end());
+
+	const float peak = sortedLevels.at((count * 95) / 100);
+	const float range = (peak - floor);
+
+	if (range < 6)
+	{
+		return segments;
+	}
+
+	const float high = (floor + qMax(6.0f, (range * 0.35f)));
+	const float low = (floor + qMax(3.0f, (range * 0.15f)));
+	const double windowLength = ((m_sampleRate > 0) ? ((m_windowFrames * 1000.0) / m_sampleRate) : double(WindowLength));
+	const int minimumWindows = qRound(MinimumSpeech / windowLength);
+	const int gapWindows = qRound(MaximumGap / windowLength);
+	int start = -1;
+	int lastActive = -1;
+	int previousEnd = 0;
+
+	for (int i = 0; i <= count; ++i)
+	{
+		const bool active = (i < count && (levels.at(i) >= high || (start >= 0 && (levels.at(i) >= low || (m_crossingRates.at(i) >= 0.3f && levels.at(i) >= (floor + 3))))));
+
+		if (active)
+		{
+			if (start < 0)
+			{
+				start = i;
+
+				while (start > previousEnd && levels.at(start - 1) >= low)
+				{
+					--start;
+				}
+			}
+
+			lastActive = i;
+		}
+		else if (start >= 0 && (i == count || (i - lastActive) > gapWindows))
+		{
+			if ((lastActive + 1 - start) >= minimumWindows)
+			{
+				SpeechSegment segment;
+				segment.begin = windowTime(start);
+				segment.end = windowTime(lastActive + 1);
+
+				segments.append(segment);
+
+				previousEnd = (lastActive + 1);
+			}
+
+			start = -1;
+		}
+	}
+
+	return segments;
+}
+
+qint64 SpeechDetector::windowTime(int window) const
+{
+	if (m_sampleRate <= 0)
+	{
+		return (qint64(window) * WindowLength);
+	}
+
+	return qRound64((window * (m_windowFrames * 1000.0)) / m_sampleRate);
+}
+
+int SpeechDetector::sampleRate() const
+{
+	return m_sampleRate;
+}
+
+int SpeechDetector::windowCount() const
+{
+	return m_energies.count();
+}
+
+bool SpeechDetector::isEmpty() const
+{
+	return m_energies.isEmpty();
+}
+
+int SpeechDetector::segmentAt(const QVector<SpeechSegment> &segments, qint64 begin, qint64 end)
+{
+	int nearest = -1;
+	qint64 bestOverlap = 0;
+	qint64 bestDistance = 0;
+
+	for (int i = 0; i < segments.count(); ++i)
+	{
+		const qint64 overlap = (qMin(end, segments.at(i).end) - qMax(begin, segments.at(i).begin));
+		const qint64 distance = qAbs(segments.at(i).begin - begin);
+
+		if (overlap > bestOverlap || (bestOverlap == 0 && overlap <= 0 && (nearest < 0 || distance < bestDistance)))
+		{
+			nearest = i;
+			bestOverlap = qMax(qint64(0), overlap);
+			bestDistance = distance;
+		}
+	}
+
+	return nearest;
+}
+
+void SpeechDetector::snap(const QVector<SpeechSegment> &segments, QVector<qint64> *begins, QVector<qint64> *ends, qint64 tolerance)
+{
+	QVector<qint64> onsets(segments.count());
+	QVector<qint64> offsets(segments.count());
+
+	for (int i = 0; i < segments.count(); ++i)
+	{
+		onsets[i] = segments.at(i).begin;
+		offsets[i] = segments.at(i).end;
+	}
+
+	for (int i = 0; i < begins->count(); ++i)
+	{
+		const qint64 begin = nearestBoundary(onsets, begins->at(i), tolerance);
+		const qint64 end = nearestBoundary(offsets, ends->at(i), tolerance);
+
+		if (end > begin)
+		{
+			(*begins)[i] = begin;
+			(*ends)[i] = end;
+		}
+	}
+}
+
+QString SpeechDetector::cachePath(const QString &mediaFile)
+{
+	const QString key = WaveformPeaks::cacheKey(mediaFile);
+
+	return (key.isEmpty() ? QString() : (QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QString("/speech/%1.dat").arg(key)));
+}
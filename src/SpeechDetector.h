@@ -0,0 +1,82 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SPEECHDETECTOR_H
+#define SPEECHDETECTOR_H
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+struct SpeechSegment
+{
+	SpeechSegment() : begin(0),
+		end(0)
+	{
+	}
+
+	qint64 begin;
+	qint64 end;
+};
+
+class SpeechDetector
+{
+public:
+	enum
+	{
+		WindowLength = 10,
+		MinimumSpeech = 200,
+		MaximumGap = 250,
+		SnapTolerance = 500
+	};
+
+	SpeechDetector();
+
+	void clear();
+	void setSampleRate(int rate);
+	void appendSamples(const qint16 *samples, int frames, int channels);
+	void finish();
+	bool load(const QString &path);
+	bool save(const QString &path) const;
+	QVector<SpeechSegment> detect() const;
+	qint64 windowTime(int window) const;
+	int sampleRate() const;
+	int windowCount() const;
+	bool isEmpty() const;
+	static int segmentAt(const QVector<SpeechSegment> &segments, qint64 begin, qint64 end);
+	static void snap(const QVector<SpeechSegment> &segments, QVector<qint64> *begins, QVector<qint64> *ends, qint64 tolerance = SnapTolerance);
+	static QString cachePath(const QString &mediaFile);
+
+protected:
+	void analyze(const qint16 *samples, int count);
+
+private:
+	QVector<float> m_energies;
+	QVector<float> m_crossingRates;
+	QVector<qint16> m_mixed;
+	float m_pendingEnergy;
+	int m_pendingCrossings;
+	int m_pendingFrames;
+	int m_windowFrames;
+	int m_sampleRate;
+	qint16 m_previousSample;
+};
+
+#endif
@@ -0,0 +1,56 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLE_H
+#define SUBTITLE_H
+
+#include <QtCore/QPoint>
+#include <QtCore/QString>
+
+struct Subtitle
+{
+	Subtitle() : begin(0),
+		end(0)
+	{
+	}
+
+	bool operator==(const Subtitle &other) const
+	{
+		return (begin == other.begin && end == other.end && position == other.position && text == other.text);
+	}
+
+	bool operator!=(const Subtitle &other) const
+	{
+		return !(*this == other);
+	}
+
+	QString text;
+	qint64 begin;
+	qint64 end;
+	QPoint position;
+};
+
+inline qint64 transformTime(qint64 time, double scale, double offset)
+{
+	return qMax(qint64(0), qRound64((time * scale) + offset));
+}
+
+#endif
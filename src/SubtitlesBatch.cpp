@@ -0,0 +1,365 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesBatch.h"
+#include "SubtitlesBinary.h"
+#include "SubtitlesCorpus.h"
+#include "SubtitlesWriter.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+
+struct CorpusFile
+{
+	SubtitlesTrack track;
+	bool parsed;
+};
+
+static CorpusFile parseCorpusFile(const QString &fileName)
+{
+	SubtitlesParser parser;
+	CorpusFile result;
+	result.parsed = parser.parseFile(fileName);
+
+	if (result.parsed)
+	{
+		result.track = parser.track();
+	}
+
+	return result;
+}
+
+SubtitlesBatch::SubtitlesBatch(Operation operation, double value) : m_operation(operation),
+	m_value(value)
+{
+}
+
+QList<SubtitlesBatch::Result> SubtitlesBatch::process(const QStringList &files, int jobs) const
+{
+	if (jobs > 0)
+	{
+		QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+	}
+
+	return QtConcurrent::blockingMapped<QList<Result> >(files, *this);
+}
+
+SubtitlesBatch::Result SubtitlesBatch::processFile(const QString &fileName) const
+{
+	SubtitlesParser parser;
+	Result result;
+	result.fileName = fileName;
+	result.subtitles = 0;
+	result.written = false;
+
+	if (!parser.parseFile(fileName))
+	{
+		result.error = QCoreApplication::translate("SubtitlesBatch", "Can not read subtitle file");
+
+		return result;
+	}
+
+	SubtitlesTrack track = parser.track();
+
+	result.errors = parser.errors();
+	result.subtitles = track.count();
+
+	if (m_operation == ValidateOperation || m_operation == CorpusOperation)
+	{
+		return result;
+	}
+
+	if (!result.errors.isEmpty())
+	{
+		result.error = QCoreApplication::translate("SubtitlesBatch", "File contains invalid lines, not rewriting");
+
+		return result;
+	}
+
+	if (m_operation == CompileOperation)
+	{
+		const QString compiledFileName = SubtitlesBinary::compiledFileName(fileName);
+		QFile file(fileName);
+		SubtitlesBinary binary;
+
+		if (!file.open(QIODevice::ReadOnly) || !binary.writeFile(compiledFileName, track, file.readAll()))
+		{
+			result.error = QCoreApplication::translate("SubtitlesBatch", "Can not save compiled subtitle file");
+
+			return result;
+		}
+
+		result.written = true;
+
+		if (!binary.open(compiledFileName) || !binary.verify(track))
+		{
+			result.error = QCoreApplication::translate("SubtitlesBatch", "Compiled subtitle file does not match source");
+		}
+
+		return result;
+	}
+
+	if (m_operation == RescaleOperation)
+	{
+		track.transform(m_value);
+	}
+	else if (m_operation == OffsetOperation)
+	{
+		track.transform(1, m_value);
+	}
+
+	SubtitlesWriter writer;
+
+	if (!writer.writeFile(fileName, track))
+	{
+		result.error = QCoreApplication::translate("SubtitlesBatch", "Can not save subtitle file");
+
+		return result;
+	}
+
+	result.written = true;
+
+	return result;
+}
+
+SubtitlesBatch::Result SubtitlesBatch::operator()(const QString &fileName) const
+{
+	return processFile(fileName);
+}
+
+QStringList SubtitlesBatch::findFiles(const QString &path)
+{
+	if (QFileInfo(path).isFile())
+	{
+		return QStringList(path);
+	}
+
+	QStringList files;
+	QDirIterator iterator(path, (QStringList() << "*.txt" << "*.txa"), QDir::Files, QDirIterator::Subdirectories);
+
+	while (iterator.hasNext())
+	{
+		files.append(iterator.next());
+	}
+
+	files.sort();
+
+	return files;
+}
+
+int SubtitlesBatch::run(const QStringList &arguments)
+{
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QCoreApplication::translate("SubtitlesBatch", "Validates, normalizes, retimes, measures or compiles all subtitle files under given paths."));
+	parser.addHelpOption();
+	parser.addOption(QCommandLineOption("batch", QCoreApplication::translate("SubtitlesBatch", "Operation to perform: validate, normalize, rescale, offset, corpus or compile."), "operation"));
+	parser.addOption(QCommandLineOption("scale", QCoreApplication::translate("SubtitlesBatch", "Time multiplier used by rescale."), "factor", "1"));
+	parser.addOption(QCommandLineOption("offset", QCoreApplication::translate("SubtitlesBatch", "Milliseconds added to all times by offset."), "milliseconds", "0"));
+	parser.addOption(QCommandLineOption((QStringList() << "j" << "jobs"), QCoreApplication::translate("SubtitlesBatch", "Number of files processed in parallel."), "N", QString::number(QThread::idealThreadCount())));
+	parser.addOption(QCommandLineOption("trace", QCoreApplication::translate("SubtitlesBatch", "Writes a Chrome trace of the run to given file."), "file"));
+	parser.addPositionalArgument("paths", QCoreApplication::translate("SubtitlesBatch", "Directories or files to process."), "<paths...>");
+
+	QTextStream errorStream(stderr);
+
+	if (!parser.parse(arguments))
+	{
+		errorStream << parser.errorText() << "\n";
+
+		return 2;
+	}
+
+	if (parser.isSet("help"))
+	{
+		errorStream << parser.helpText();
+
+		return 0;
+	}
+
+	const QString operationName = parser.value("batch");
+	Operation operation = ValidateOperation;
+	double value = 0;
+	bool ok = true;
+
+	if (operationName == "validate")
+	{
+		operation = ValidateOperation;
+	}
+	else if (operationName == "normalize")
+	{
+		operation = NormalizeOperation;
+	}
+	else if (operationName == "rescale")
+	{
+		operation = RescaleOperation;
+		value = parser.value("scale").toDouble(&ok);
+		ok = (ok && value > 0);
+	}
+	else if (operationName == "offset")
+	{
+		operation = OffsetOperation;
+		value = parser.value("offset").toLongLong(&ok);
+	}
+	else if (operationName == "corpus")
+	{
+		operation = CorpusOperation;
+	}
+	else if (operationName == "compile")
+	{
+		operation = CompileOperation;
+	}
+	else
+	{
+		ok = false;
+	}
+
+	const int jobs = parser.value("jobs").toInt();
+
+	if (!ok || jobs < 1 || parser.positionalArguments().isEmpty())
+	{
+		errorStream << parser.helpText();
+
+		return 2;
+	}
+
+	QStringList files;
+
+	for (int i = 0; i < parser.positionalArguments().count(); ++i)
+	{
+		files.append(findFiles(parser.positionalArguments().at(i)));
+	}
+
+	if (operation == CorpusOperation)
+	{
+		return reportCorpus(files, jobs);
+	}
+
+	const QList<Result> results = SubtitlesBatch(operation, value).process(files, jobs);
+	QJsonArray entries;
+	int failed = 0;
+	int subtitles = 0;
+	int written = 0;
+
+	for (int i = 0; i < results.count(); ++i)
+	{
+		const Result &result = results.at(i);
+		QJsonArray errors;
+
+		for (int j = 0; j < result.errors.count(); ++j)
+		{
+			QJsonObject error;
+			error.insert("line", result.errors.at(j).line);
+			error.insert("column", result.errors.at(j).column);
+			error.insert("message", result.errors.at(j).message);
+
+			errors.append(error);
+		}
+
+		const bool success = (result.error.isEmpty() && result.errors.isEmpty());
+		QJsonObject entry;
+		entry.insert("file", result.fileName);
+		entry.insert("status", (success ? QString("ok") : QString("failed")));
+		entry.insert("subtitles", result.subtitles);
+		entry.insert("written", result.written);
+		entry.insert("errors", errors);
+
+		if (!result.error.isEmpty())
+		{
+			entry.insert("error", result.error);
+		}
+
+		entries.append(entry);
+
+		subtitles += result.subtitles;
+
+		if (!success)
+		{
+			++failed;
+		}
+
+		if (result.written)
+		{
+			++written;
+		}
+	}
+
+	QJsonObject summary;
+	summary.insert("operation", operationName);
+	summary.insert("files", results.count());
+	summary.insert("failed", failed);
+	summary.insert("written", written);
+	summary.insert("subtitles", subtitles);
+	summary.insert("results", entries);
+
+	QTextStream(stdout) << QJsonDocument(summary).toJson();
+
+	return (failed ? 1 : 0);
+}
+
+int SubtitlesBatch::reportCorpus(const QStringList &files, int jobs)
+{
+	const int chunkSize = (jobs * 4);
+	SubtitlesCorpus corpus;
+	QJsonArray failedFiles;
+
+	QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+
+	for (int i = 0; i < files.count(); i += chunkSize)
+	{
+		const QStringList chunk = files.mid(i, chunkSize);
+		const QList<CorpusFile> parsedFiles = QtConcurrent::blockingMapped<QList<CorpusFile> >(chunk, parseCorpusFile);
+
+		for (int j = 0; j < parsedFiles.count(); ++j)
+		{
+			if (parsedFiles.at(j).parsed)
+			{
+				corpus.addTrack(chunk.at(j), parsedFiles.at(j).track);
+			}
+			else
+			{
+				failedFiles.append(chunk.at(j));
+			}
+		}
+	}
+
+	QJsonObject summary;
+	summary.insert("operation", QString("corpus"));
+	summary.insert("files", files.count());
+	summary.insert("failed", failedFiles.count());
+	summary.insert("subtitles", corpus.subtitleCount());
+	summary.insert("uniqueStrings", corpus.textStore()->count());
+	summary.insert("textBytes", double(corpus.textStore()->textSize()));
+	summary.insert("residentBytes", double(corpus.memoryUsage()));
+	summary.insert("estimatedListBytes", double(corpus.estimatedListMemoryUsage()));
+	summary.insert("failedFiles", failedFiles);
+
+	QTextStream(stdout) << QJsonDocument(summary).toJson();
+
+	return (failedFiles.isEmpty() ? 0 : 1);
+}
@@ -0,0 +1,69 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESBATCH_H
+#define SUBTITLESBATCH_H
+
+#include "SubtitlesParser.h"
+
+#include <QtCore/QStringList>
+
+class SubtitlesBatch
+{
+public:
+	enum Operation
+	{
+		ValidateOperation = 0,
+		NormalizeOperation,
+		RescaleOperation,
+		OffsetOperation,
+		CorpusOperation,
+		CompileOperation
+	};
+
+	struct Result
+	{
+		QString fileName;
+		QString error;
+		QList<SubtitlesParserError> errors;
+		int subtitles;
+		bool written;
+	};
+
+	typedef Result result_type;
+
+	SubtitlesBatch(Operation operation, double value = 0);
+
+	QList<Result> process(const QStringList &files, int jobs) const;
+	Result processFile(const QString &fileName) const;
+	Result operator()(const QString &fileName) const;
+	static QStringList findFiles(const QString &path);
+	static int run(const QStringList &arguments);
+
+protected:
+	static int reportCorpus(const QStringList &files, int jobs);
+
+private:
+	Operation m_operation;
+	double m_value;
+};
+
+#endif
@@ -0,0 +1,417 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesBinary.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+// Layout, all integers little endian:
+// header (magic, version, header size, count, maximum length, strings offset, strings size, flags,
+// reserved, source size, source fingerprint), begins qint64[count], ends qint64[count],
+// positions qint32[count * 2], text offsets quint32[count + 1], UTF-8 text blob;
+// entries are sorted by begin time and OrderedFlag marks sources that already were in that order
+
+static qint64 sectionOffset(int count, int section)
+{
+	return (SubtitlesBinary::HeaderSize + (qint64(count) * 8 * section));
+}
+
+struct StableBeginLessThan
+{
+	explicit StableBeginLessThan(const qint64 *begins) : m_begins(begins)
+	{
+	}
+
+	bool operator()(int first, int second) const
+	{
+		return (m_begins[first] < m_begins[second] || (m_begins[first] == m_begins[second] && first < second));
+	}
+
+	const qint64 *m_begins;
+};
+
+SubtitlesBinary::SubtitlesBinary() : m_data(NULL),
+	m_strings(NULL),
+	m_size(0),
+	m_maximumLength(0),
+	m_stringsSize(0),
+	m_flags(0),
+	m_count(0)
+{
+}
+
+SubtitlesBinary::~SubtitlesBinary()
+{
+	close();
+}
+
+bool SubtitlesBinary::open(const QString &fileName)
+{
+	close();
+
+	m_file.setFileName(fileName);
+
+	if (!m_file.open(QIODevice::ReadOnly))
+	{
+		m_errorString = m_file.errorString();
+
+		return false;
+	}
+
+	const qint64 size = m_file.size();
+	const uchar *data = m_file.map(0, size);
+
+	if (!data)
+	{
+		m_buffer = m_file.readAll();
+
+		data = reinterpret_cast<const uchar*>(m_buffer.constData());
+	}
+
+	if (!map(data, size))
+	{
+		close();
+
+		return false;
+	}
+
+	return true;
+}
+
+bool SubtitlesBinary::setData(const QByteArray &data)
+{
+	close();
+
+	m_buffer = data;
+
+	if (!map(reinterpret_cast<const uchar*>(m_buffer.constData()), m_buffer.size()))
+	{
+		close();
+
+		return false;
+	}
+
+	return true;
+}
+
+bool SubtitlesBinary::map(const uchar *data, qint64 size)
+{
+	m_errorString = QCoreApplication::translate("SubtitlesBinary", "Invalid compiled subtitles file");
+
+	if (!data || size < HeaderSize || qFromLittleEndian<quint32>(data) != Magic || qFromLittleEndian<quint16>(data + 4) != Version || qFromLittleEndian<quint16>(data + 6) != HeaderSize)
+	{
+		return false;
+	}
+
+	const int count = int(qFromLittleEndian<quint32>(data + 8));
+	const quint32 stringsOffset = qFromLittleEndian<quint32>(data + 16);
+	const quint32 stringsSize = qFromLittleEndian<quint32>(data + 20);
+
+	if (count < 0 || stringsOffset != (sectionOffset(count, 3) + ((qint64(count) + 1) * 4)) || (qint64(stringsOffset) + stringsSize) > size || qFromLittleEndian<quint32>(data + sectionOffset(count, 3) + (qint64(count) * 4)) != stringsSize)
+	{
+		return false;
+	}
+
+	m_data = data;
+	m_strings = (data + stringsOffset);
+	m_size = size;
+	m_maximumLength = qFromLittleEndian<quint32>(data + 12);
+	m_stringsSize = stringsSize;
+	m_flags = qFromLittleEndian<quint32>(data + 24);
+	m_count = count;
+	m_errorString.clear();
+
+	return true;
+}
+
+void SubtitlesBinary::close()
+{
+	if (m_file.isOpen())
+	{
+		m_file.close();
+	}
+
+	m_buffer.clear();
+
+	m_data = NULL;
+	m_strings = NULL;
+	m_size = 0;
+	m_maximumLength = 0;
+	m_stringsSize = 0;
+	m_flags = 0;
+	m_count = 0;
+}
+
+bool SubtitlesBinary::writeFile(const QString &fileName, const SubtitlesTrack &track, const QByteArray &source)
+{
+	QSaveFile file(fileName);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		m_errorString = file.errorString();
+
+		return false;
+	}
+
+	const QByteArray data = compile(track, source);
+
+	if (file.write(data) != data.size() || !file.commit())
+	{
+		m_errorString = file.errorString();
+
+		return false;
+	}
+
+	m_errorString.clear();
+
+	return true;
+}
+
+bool SubtitlesBinary::verify(const SubtitlesTrack &track) const
+{
+	if (track.count() != m_count)
+	{
+		return false;
+	}
+
+	const SubtitlesTrack expected = sorted(track);
+
+	for (int i = 0; i < m_count; ++i)
+	{
+		if (expected.begin(i) != begin(i) || expected.end(i) != end(i) || expected.position(i) != position(i) || expected.text(i) != text(i))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool SubtitlesBinary::matchesSource(const QByteArray &source) const
+{
+	if (!m_data || qFromLittleEndian<qint64>(m_data + 32) != source.size())
+	{
+		return false;
+	}
+
+	const QByteArray hash = fingerprint(source);
+
+	return (memcmp((m_data + 40), hash.constData(), 8) == 0);
+}
+
+SubtitlesTrack SubtitlesBinary::track() const
+{
+	SubtitlesTrack result;
+	result.reserve(m_count);
+
+	for (int i = 0; i < m_count; ++i)
+	{
+		Subtitle subtitle;
+		subtitle.begin = begin(i);
+		subtitle.end = end(i);
+		subtitle.position = position(i);
+		subtitle.text = text(i);
+
+		result.append(subtitle);
+	}
+
+	return result;
+}
+
+QVector<int> SubtitlesBinary::activeSubtitles(qint64 time) const
+{
+	QVector<int> subtitles;
+	int low = 0;
+	int high = m_count;
+
+	while (low < high)
+	{
+		const int middle = (low + ((high - low) / 2));
+
+		if (begin(middle) <= time)
+		{
+			low = (middle + 1);
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	for (int i = (low - 1); i >= 0 && begin(i) > (time - m_maximumLength); --i)
+	{
+		if (end(i) > time)
+		{
+			subtitles.append(i);
+		}
+	}
+
+	std::reverse(subtitles.begin(), subtitles.end());
+
+	return subtitles;
+}
+
+QString SubtitlesBinary::text(int subtitle) const
+{
+	const uchar *offsets = (m_data + sectionOffset(m_count, 3));
+	const quint32 offset = qFromLittleEndian<quint32>(offsets + (qint64(subtitle) * 4));
+	const quint32 next = qFromLittleEndian<quint32>(offsets + ((qint64(subtitle) + 1) * 4));
+
+	if (offset > next || next > m_stringsSize)
+	{
+		return QString();
+	}
+
+	return QString::fromUtf8(reinterpret_cast<const char*>(m_strings + offset), int(next - offset));
+}
+
+QString SubtitlesBinary::errorString() const
+{
+	return m_errorString;
+}
+
+QPoint SubtitlesBinary::position(int subtitle) const
+{
+	const uchar *positions = (m_data + sectionOffset(m_count, 2) + (qint64(subtitle) * 8));
+
+	return QPoint(qFromLittleEndian<qint32>(positions), qFromLittleEndian<qint32>(positions + 4));
+}
+
+qint64 SubtitlesBinary::begin(int subtitle) const
+{
+	return qFromLittleEndian<qint64>(m_data + sectionOffset(m_count, 0) + (qint64(subtitle) * 8));
+}
+
+qint64 SubtitlesBinary::end(int subtitle) const
+{
+	return qFromLittleEndian<qint64>(m_data + sectionOffset(m_count, 1) + (qint64(subtitle) * 8));
+}
+
+int SubtitlesBinary::count() const
+{
+	return m_count;
+}
+
+bool SubtitlesBinary::isOpen() const
+{
+	return (m_data != NULL);
+}
+
+bool SubtitlesBinary::isOrdered() const
+{
+	return (m_flags & OrderedFlag);
+}
+
+QByteArray SubtitlesBinary::compile(const SubtitlesTrack &track, const QByteArray &sourceData)
+{
+	const SubtitlesTrack source = sorted(track);
+	const int count = source.count();
+	bool ordered = true;
+
+	for (int i = 1; i < track.count() && ordered; ++i)
+	{
+		ordered = (track.begin(i - 1) <= track.begin(i));
+	}
+	QList<QByteArray> texts;
+	qint64 maximumLength = 0;
+	quint32 stringsSize = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		texts.append(source.text(i).toUtf8());
+
+		stringsSize += texts.last().size();
+		maximumLength = qMax(maximumLength, (source.end(i) - source.begin(i)));
+	}
+
+	const quint32 stringsOffset = quint32(sectionOffset(count, 3) + ((qint64(count) + 1) * 4));
+	QByteArray data((stringsOffset + stringsSize), '\0');
+	uchar *output = reinterpret_cast<uchar*>(data.data());
+
+	qToLittleEndian<quint32>(Magic, output);
+	qToLittleEndian<quint16>(Version, (output + 4));
+	qToLittleEndian<quint16>(HeaderSize, (output + 6));
+	qToLittleEndian<quint32>(count, (output + 8));
+	qToLittleEndian<quint32>(quint32(qMin(maximumLength, qint64(0xFFFFFFFF))), (output + 12));
+	qToLittleEndian<quint32>(stringsOffset, (output + 16));
+	qToLittleEndian<quint32>(stringsSize, (output + 20));
+	qToLittleEndian<quint32>((ordered ? quint32(OrderedFlag) : 0), (output + 24));
+	qToLittleEndian<qint64>(sourceData.size(), (output + 32));
+
+	memcpy((output + 40), fingerprint(sourceData).constData(), 8);
+
+	quint32 offset = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		qToLittleEndian<qint64>(source.begin(i), (output + sectionOffset(count, 0) + (qint64(i) * 8)));
+		qToLittleEndian<qint64>(source.end(i), (output + sectionOffset(count, 1) + (qint64(i) * 8)));
+		qToLittleEndian<qint32>(source.position(i).x(), (output + sectionOffset(count, 2) + (qint64(i) * 8)));
+		qToLittleEndian<qint32>(source.position(i).y(), (output + sectionOffset(count, 2) + (qint64(i) * 8) + 4));
+		qToLittleEndian<quint32>(offset, (output + sectionOffset(count, 3) + (qint64(i) * 4)));
+
+		memcpy((output + stringsOffset + offset), texts.at(i).constData(), texts.at(i).size());
+
+		offset += texts.at(i).size();
+	}
+
+	qToLittleEndian<quint32>(offset, (output + sectionOffset(count, 3) + (qint64(count) * 4)));
+
+	return data;
+}
+
+QByteArray SubtitlesBinary::fingerprint(const QByteArray &source)
+{
+	return QCryptographicHash::hash(source, QCryptographicHash::Sha1).left(8);
+}
+
+QString SubtitlesBinary::compiledFileName(const QString &fileName)
+{
+	return (fileName + ".bin");
+}
+
+SubtitlesTrack SubtitlesBinary::sorted(const SubtitlesTrack &track)
+{
+	QVector<int> order(track.count());
+
+	for (int i = 0; i < order.count(); ++i)
+	{
+		order[i] = i;
+	}
+
+	std::sort(order.begin(), order.end(), StableBeginLessThan(track.begins()));
+
+	SubtitlesTrack result;
+	result.reserve(order.count());
+
+	for (int i = 0; i < order.count(); ++i)
+	{
+		result.append(track.subtitle(order.at(i)));
+	}
+
+	return result;
+}
@@ -0,0 +1,82 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESBINARY_H
+#define SUBTITLESBINARY_H
+
+#include "SubtitlesTrack.h"
+
+#include <QtCore/QFile>
+
+class SubtitlesBinary
+{
+public:
+	enum
+	{
+		Magic = 0x42535A57,
+		Version = 2,
+		HeaderSize = 48,
+		OrderedFlag = 1
+	};
+
+	SubtitlesBinary();
+	~SubtitlesBinary();
+
+	bool open(const QString &fileName);
+	bool setData(const QByteArray &data);
+	void close();
+	bool writeFile(const QString &fileName, const SubtitlesTrack &track, const QByteArray &source = QByteArray());
+	bool verify(const SubtitlesTrack &track) const;
+	bool matchesSource(const QByteArray &source) const;
+	SubtitlesTrack track() const;
+	QVector<int> activeSubtitles(qint64 time) const;
+	QString text(int subtitle) const;
+	QString errorString() const;
+	QPoint position(int subtitle) const;
+	qint64 begin(int subtitle) const;
+	qint64 end(int subtitle) const;
+	int count() const;
+	bool isOpen() const;
+	bool isOrdered() const;
+	static QByteArray compile(const SubtitlesTrack &track, const QByteArray &source = QByteArray());
+	static QByteArray fingerprint(const QByteArray &source);
+	static SubtitlesTrack sorted(const SubtitlesTrack &track);
+	static QString compiledFileName(const QString &fileName);
+
+protected:
+	bool map(const uchar *data, qint64 size);
+
+private:
+	QFile m_file;
+	QByteArray m_buffer;
+	const uchar *m_data;
+	const uchar *m_strings;
+	qint64 m_size;
+	qint64 m_maximumLength;
+	quint32 m_stringsSize;
+	quint32 m_flags;
+	int m_count;
+	QString m_errorString;
+
+	Q_DISABLE_COPY(SubtitlesBinary)
+};
+
+#endif
@@ -0,0 +1,28 @@
+INCLUDEPATH += $$PWD
+SOURCES += $$PWD/SpeechDetector.cpp \
+	$$PWD/SubtitlesBinary.cpp \
+	$$PWD/SubtitlesCorpus.cpp \
+	$$PWD/SubtitlesIndex.cpp \
+	$$PWD/SubtitlesLinter.cpp \
+	$$PWD/SubtitlesMerge.cpp \
+	$$PWD/SubtitlesParser.cpp \
+	$$PWD/SubtitlesRetimer.cpp \
+	$$PWD/SubtitlesTextStore.cpp \
+	$$PWD/SubtitlesTrace.cpp \
+	$$PWD/SubtitlesTrack.cpp \
+	$$PWD/SubtitlesWriter.cpp \
+	$$PWD/WaveformPeaks.cpp
+HEADERS += $$PWD/SpeechDetector.h \
+	$$PWD/Subtitle.h \
+	$$PWD/SubtitlesBinary.h \
+	$$PWD/SubtitlesCorpus.h \
+	$$PWD/SubtitlesIndex.h \
+	$$PWD/SubtitlesLinter.h \
+	$$PWD/SubtitlesMerge.h \
+	$$PWD/SubtitlesParser.h \
+	$$PWD/SubtitlesRetimer.h \
+	$$PWD/SubtitlesTextStore.h \
+	$$PWD/SubtitlesTrace.h \
+	$$PWD/SubtitlesTrack.h \
+	$$PWD/SubtitlesWriter.h \
+	$$PWD/WaveformPeaks.h
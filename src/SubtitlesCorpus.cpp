@@ -0,0 +1,160 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesCorpus.h"
+#include "SubtitlesParser.h"
+
+SubtitlesCorpus::SubtitlesCorpus() : m_estimatedListMemoryUsage(0),
+	m_subtitles(0)
+{
+}
+
+void SubtitlesCorpus::clear()
+{
+	m_texts.clear();
+	m_tracks.clear();
+	m_estimatedListMemoryUsage = 0;
+	m_subtitles = 0;
+}
+
+int SubtitlesCorpus::addTrack(const QString &fileName, const SubtitlesTrack &track)
+{
+	CompactTrack compactTrack;
+	compactTrack.fileName = fileName;
+	compactTrack.begins = track.beginTimes();
+	compactTrack.ends = track.endTimes();
+	compactTrack.positions.reserve(track.count());
+	compactTrack.texts.reserve(track.count());
+
+	for (int i = 0; i < track.count(); ++i)
+	{
+		compactTrack.positions.append(track.position(i));
+		compactTrack.texts.append(m_texts.intern(track.text(i)));
+	}
+
+	m_tracks.append(compactTrack);
+
+	m_estimatedListMemoryUsage += estimatedListMemoryUsage(track);
+	m_subtitles += track.count();
+
+	return (m_tracks.count() - 1);
+}
+
+int SubtitlesCorpus::addFile(const QString &fileName)
+{
+	SubtitlesParser parser;
+
+	if (!parser.parseFile(fileName))
+	{
+		return -1;
+	}
+
+	return addTrack(fileName, parser.track());
+}
+
+SubtitlesTrack SubtitlesCorpus::track(int track) const
+{
+	const CompactTrack &compactTrack = m_tracks.at(track);
+	SubtitlesTrack result;
+	result.reserve(compactTrack.texts.count());
+
+	for (int i = 0; i < compactTrack.texts.count(); ++i)
+	{
+		Subtitle subtitle;
+		subtitle.begin = compactTrack.begins.at(i);
+		subtitle.end = compactTrack.ends.at(i);
+		subtitle.position = compactTrack.positions.at(i);
+		subtitle.text = m_texts.text(compactTrack.texts.at(i));
+
+		result.append(subtitle);
+	}
+
+	return result;
+}
+
+QString SubtitlesCorpus::fileName(int track) const
+{
+	return m_tracks.at(track).fileName;
+}
+
+QString SubtitlesCorpus::text(int track, int subtitle) const
+{
+	return m_texts.text(m_tracks.at(track).texts.at(subtitle));
+}
+
+quint32 SubtitlesCorpus::textHandle(int track, int subtitle) const
+{
+	return m_tracks.at(track).texts.at(subtitle);
+}
+
+const SubtitlesTextStore* SubtitlesCorpus::textStore() const
+{
+	return &m_texts;
+}
+
+int SubtitlesCorpus::trackCount() const
+{
+	return m_tracks.count();
+}
+
+int SubtitlesCorpus::subtitleCount() const
+{
+	return m_subtitles;
+}
+
+qint64 SubtitlesCorpus::memoryUsage() const
+{
+	qint64 usage = (m_texts.memoryUsage() + (m_tracks.capacity() * sizeof(CompactTrack)));
+
+	for (int i = 0; i < m_tracks.count(); ++i)
+	{
+		const CompactTrack &compactTrack = m_tracks.at(i);
+
+		usage += ((compactTrack.fileName.size() * sizeof(QChar)) + (compactTrack.begins.capacity() * sizeof(qint64)) + (compactTrack.ends.capacity() * sizeof(qint64)) + (compactTrack.positions.capacity() * sizeof(QPoint)) + (compactTrack.texts.capacity() * sizeof(quint32)));
+	}
+
+	return usage;
+}
+
+qint64 SubtitlesCorpus::estimatedListMemoryUsage() const
+{
+	return m_estimatedListMemoryUsage;
+}
+
+qint64 SubtitlesCorpus::estimatedListMemoryUsage(const SubtitlesTrack &track)
+{
+	const qint64 allocationOverhead = 16;
+	qint64 usage = 0;
+
+	for (int i = 0; i < track.count(); ++i)
+	{
+		const int length = track.text(i).length();
+
+		usage += (sizeof(void*) + sizeof(Subtitle) + allocationOverhead);
+
+		if (length > 0)
+		{
+			usage += (sizeof(QArrayData) + ((length + 1) * sizeof(QChar)) + allocationOverhead);
+		}
+	}
+
+	return usage;
+}
@@ -0,0 +1,66 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESCORPUS_H
+#define SUBTITLESCORPUS_H
+
+#include "SubtitlesTextStore.h"
+#include "SubtitlesTrack.h"
+
+#include <QtCore/QStringList>
+
+class SubtitlesCorpus
+{
+public:
+	SubtitlesCorpus();
+
+	void clear();
+	int addTrack(const QString &fileName, const SubtitlesTrack &track);
+	int addFile(const QString &fileName);
+	SubtitlesTrack track(int track) const;
+	QString fileName(int track) const;
+	QString text(int track, int subtitle) const;
+	quint32 textHandle(int track, int subtitle) const;
+	const SubtitlesTextStore* textStore() const;
+	int trackCount() const;
+	int subtitleCount() const;
+	qint64 memoryUsage() const;
+	qint64 estimatedListMemoryUsage() const;
+	static qint64 estimatedListMemoryUsage(const SubtitlesTrack &track);
+
+protected:
+	struct CompactTrack
+	{
+		QString fileName;
+		QVector<qint64> begins;
+		QVector<qint64> ends;
+		QVector<QPoint> positions;
+		QVector<quint32> texts;
+	};
+
+private:
+	SubtitlesTextStore m_texts;
+	QVector<CompactTrack> m_tracks;
+	qint64 m_estimatedListMemoryUsage;
+	int m_subtitles;
+};
+
+#endif
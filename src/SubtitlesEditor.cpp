@@ -19,64 +19,153 @@
 ***********************************************************************************/
 
 #include "SubtitlesEditor.h"
+#include "PlaybackClock.h"
+#include "RetimeDialog.h"
+#include "SearchBrowser.h"
+#include "SeekScheduler.h"
+#include "SubtitlesBinary.h"
+#include "SequencesBrowser.h"
+#include "SequencesIndexer.h"
+#include "SubtitlesHistory.h"
+#include "SubtitlesJournal.h"
+#include "SubtitlesMerge.h"
+#include "SubtitlesModel.h"
+#include "SubtitlesOverlay.h"
+#include "SubtitlesParser.h"
+#include "SubtitlesTable.h"
+#include "SubtitlesTimeline.h"
+#include "SubtitlesTrace.h"
+#include "SubtitlesWriter.h"
+#include "ThumbnailLoader.h"
+#include "WaveformLoader.h"
 
 #include "ui_SubtitlesEditor.h"
 
+#include <QtCore/QFileSystemWatcher>
 #include <QtCore/QSettings>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
+#include <QtGui/QPixmap>
+#include <QtWidgets/QDockWidget>
 #include <QtWidgets/QLabel>
+#include <QtWidgets/QProgressBar>
+#include <QtWidgets/QStyle>
 #include <QtWidgets/QTabBar>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QFileDialog>
-#include <QtWidgets/QInputDialog>
-#include <QtWidgets/QGraphicsDropShadowEffect>
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
 	m_ui(new Ui::MainWindow),
 	m_mediaPlayer(new QMediaPlayer(this)),
+	m_clock(new PlaybackClock(this)),
+	m_seekScheduler(new SeekScheduler(m_mediaPlayer, this)),
+	m_journal(new SubtitlesJournal(this)),
+	m_indexer(new SequencesIndexer(this)),
+	m_loader(new SequencesLoader(this)),
+	m_waveformLoader(new WaveformLoader(this)),
+	m_thumbnailLoader(new ThumbnailLoader(this)),
+	m_sequencesBrowser(NULL),
+	m_searchBrowser(NULL),
+	m_timeline(NULL),
+	m_subtitlesModel(NULL),
+	m_subtitlesTable(NULL),
+	m_tabBar(NULL),
+	m_loadingProgressBar(new QProgressBar(this)),
+	m_problemsLabel(new QLabel(this)),
+	m_thumbnailLabel(new QLabel(this, Qt::ToolTip)),
+	m_fileWatcher(new QFileSystemWatcher(this)),
+	m_reloadTimer(new QTimer(this)),
 	m_videoWidget(new QGraphicsVideoItem()),
-	m_subtitlesTopWidget(new QGraphicsTextItem(m_videoWidget)),
-	m_subtitlesBottomWidget(new QGraphicsTextItem(m_videoWidget)),
+	m_subtitlesTopWidget(new SubtitlesOverlay(Qt::AlignTop, m_videoWidget)),
+	m_subtitlesBottomWidget(new SubtitlesOverlay(Qt::AlignBottom, m_videoWidget)),
 	m_currentSubtitle(0),
-	m_currentTrack(0)
+	m_currentTrack(0),
+	m_topTrack(0),
+	m_bottomTrack(1),
+	m_viewCounter(0)
 {
 	m_ui->setupUi(this);
 
-	m_subtitles.append(QList<Subtitle>());
-	m_subtitles.append(QList<Subtitle>());
+	m_subtitles.append(SubtitlesTrack());
+	m_subtitles.append(SubtitlesTrack());
 
-	m_mediaPlayer->setVolume(QSettings().value("Player/volume", 80).toInt());
-	m_mediaPlayer->setVideoOutput(m_videoWidget);
-	m_mediaPlayer->setNotifyInterval(100);
+	m_baseSubtitles = m_subtitles;
+
+	for (int i = 0; i < m_subtitles.count(); ++i)
+	{
+		TrackInformation information;
+		information.placement = (i ? BottomPlacement : TopPlacement);
+		information.loaded = true;
 
-	QGraphicsDropShadowEffect *topShadowEffect = new QGraphicsDropShadowEffect(m_subtitlesTopWidget);
-	topShadowEffect->setOffset(0, 0);
-	topShadowEffect->setBlurRadius(3);
-	topShadowEffect->setColor(QColor(Qt::black));
+		m_trackInformation.append(information);
+	}
 
-	m_subtitlesTopWidget->setGraphicsEffect(topShadowEffect);
-	m_subtitlesTopWidget->setDefaultTextColor(QColor(230, 230, 230));
+	m_reloadTimer->setSingleShot(true);
+	m_reloadTimer->setInterval(300);
 
-	QGraphicsDropShadowEffect *bottomShadowEffect = new QGraphicsDropShadowEffect(m_subtitlesBottomWidget);
-	bottomShadowEffect->setOffset(0, 0);
-	bottomShadowEffect->setBlurRadius(3);
-	bottomShadowEffect->setColor(QColor(Qt::black));
+	m_history = new SubtitlesHistory(&m_subtitles, this);
+	m_history->setMemoryLimit(QSettings().value("History/memoryLimit", 16).toLongLong() * 1024 * 1024);
+	m_history->setJournal(m_journal);
 
-	m_subtitlesBottomWidget->setGraphicsEffect(bottomShadowEffect);
-	m_subtitlesBottomWidget->setDefaultTextColor(QColor(230, 230, 230));
+	m_mediaPlayer->setVolume(QSettings().value("Player/volume", 80).toInt());
+	m_mediaPlayer->setVideoOutput(m_videoWidget);
+	m_mediaPlayer->setNotifyInterval(100);
 
 	m_ui->graphicsView->setScene(new QGraphicsScene(this));
 	m_ui->graphicsView->scene()->addItem(m_videoWidget);
 	m_ui->graphicsView->installEventFilter(this);
 
-	QTabBar *tabBar = new QTabBar(m_ui->centralWidget);
-	tabBar->setDocumentMode(true);
-	tabBar->setShape(QTabBar::RoundedWest);
-	tabBar->addTab(tr("Top"));
-	tabBar->addTab(tr("Bottom"));
-	tabBar->setCurrentIndex(1);
+	m_tabBar = new QTabBar(m_ui->centralWidget);
+	m_tabBar->setDocumentMode(true);
+	m_tabBar->setShape(QTabBar::RoundedWest);
+
+	updateTabs();
+
+	m_tabBar->setCurrentIndex(1);
+
+	m_ui->tabBarLayout->insertWidget(0, m_tabBar);
+
+	m_sequencesBrowser = new SequencesBrowser(this);
+
+	QDockWidget *sequencesDockWidget = new QDockWidget(tr("Sequences"), this);
+	sequencesDockWidget->setObjectName("sequencesDockWidget");
+	sequencesDockWidget->setWidget(m_sequencesBrowser);
+
+	addDockWidget(Qt::LeftDockWidgetArea, sequencesDockWidget);
+
+	m_searchBrowser = new SearchBrowser(this);
 
-	m_ui->tabBarLayout->insertWidget(0, tabBar);
+	QDockWidget *searchDockWidget = new QDockWidget(tr("Search"), this);
+	searchDockWidget->setObjectName("searchDockWidget");
+	searchDockWidget->setWidget(m_searchBrowser);
+
+	addDockWidget(Qt::LeftDockWidgetArea, searchDockWidget);
+	tabifyDockWidget(sequencesDockWidget, searchDockWidget);
+
+	sequencesDockWidget->raise();
+
+	m_timeline = new SubtitlesTimeline(this);
+	m_timeline->setTracks(&m_subtitles);
+	m_timeline->setWaveform(m_waveformLoader->peaks());
+
+	QDockWidget *timelineDockWidget = new QDockWidget(tr("Timeline"), this);
+	timelineDockWidget->setObjectName("timelineDockWidget");
+	timelineDockWidget->setWidget(m_timeline);
+
+	addDockWidget(Qt::BottomDockWidgetArea, timelineDockWidget);
+
+	m_subtitlesModel = new SubtitlesModel(&m_subtitles, m_history, this);
+	m_subtitlesTable = new SubtitlesTable(this);
+	m_subtitlesTable->setModel(m_subtitlesModel);
+
+	QDockWidget *subtitlesDockWidget = new QDockWidget(tr("Subtitles"), this);
+	subtitlesDockWidget->setObjectName("subtitlesDockWidget");
+	subtitlesDockWidget->setWidget(m_subtitlesTable);
+
+	addDockWidget(Qt::BottomDockWidgetArea, subtitlesDockWidget);
+	tabifyDockWidget(timelineDockWidget, subtitlesDockWidget);
+
+	timelineDockWidget->raise();
 
 	m_ui->actionPlayPause->setIcon(QIcon::fromTheme("media-playback-start", style()->standardIcon(QStyle::SP_MediaPlay)));
 	m_ui->actionPlayPause->setShortcut(tr("Space"));
@@ -89,12 +178,27 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
 	QLabel *fileNameLabel = new QLabel(tr("No file loaded"), this);
 	fileNameLabel->setMaximumWidth(300);
 
+	m_loadingProgressBar->setMaximumWidth(150);
+	m_loadingProgressBar->setTextVisible(false);
+	m_loadingProgressBar->hide();
+
+	m_problemsLabel->setStyleSheet("color: #c00;");
+	m_problemsLabel->hide();
+
+	m_thumbnailLabel->setFrameShape(QFrame::Box);
+	m_thumbnailLabel->hide();
+
 	m_ui->actionOpen->setIcon(QIcon::fromTheme("document-open", style()->standardIcon(QStyle::SP_DirOpenIcon)));
 	m_ui->menuOpenRecent->setIcon(QIcon::fromTheme("document-open-recent"));
+	m_ui->actionOpenSequences->setIcon(QIcon::fromTheme("folder-open"));
 	m_ui->actionClearRecentFiles->setIcon(QIcon::fromTheme("edit-clear-list"));
 	m_ui->actionSave->setIcon(QIcon::fromTheme("document-save", style()->standardIcon(QStyle::SP_DialogSaveButton)));
 	m_ui->actionSaveAs->setIcon(QIcon::fromTheme("document-save-as"));
 	m_ui->actionExit->setIcon(QIcon::fromTheme("application-exit", style()->standardIcon(QStyle::SP_DialogCloseButton)));
+	m_ui->actionUndo->setIcon(QIcon::fromTheme("edit-undo"));
+	m_ui->actionUndo->setShortcut(QKeySequence::Undo);
+	m_ui->actionRedo->setIcon(QIcon::fromTheme("edit-redo"));
+	m_ui->actionRedo->setShortcut(QKeySequence::Redo);
 	m_ui->actionAdd->setIcon(QIcon::fromTheme("list-add"));
 	m_ui->actionRemove->setIcon(QIcon::fromTheme("list-remove"));
 	m_ui->actionPrevious->setIcon(QIcon::fromTheme("go-previous"));
@@ -107,6 +211,8 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
 	m_ui->removeButton->setDefaultAction(m_ui->actionRemove);
 	m_ui->previousButton->setDefaultAction(m_ui->actionPrevious);
 	m_ui->nextButton->setDefaultAction(m_ui->actionNext);
+	m_ui->statusBar->addPermanentWidget(m_problemsLabel);
+	m_ui->statusBar->addPermanentWidget(m_loadingProgressBar);
 	m_ui->statusBar->addPermanentWidget(fileNameLabel);
 	m_ui->statusBar->addPermanentWidget(timeLabel);
 	m_ui->volumeSlider->setValue(m_mediaPlayer->volume());
@@ -123,27 +229,73 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
 	connect(m_ui->menuFile, SIGNAL(aboutToShow()), this, SLOT(updateRecentFilesMenu()));
 	connect(m_ui->actionOpen, SIGNAL(triggered()), this, SLOT(actionOpen()));
 	connect(m_ui->menuOpenRecent, SIGNAL(triggered(QAction*)), this, SLOT(actionOpenRecent(QAction*)));
+	connect(m_ui->actionOpenSequences, SIGNAL(triggered()), this, SLOT(actionOpenSequences()));
 	connect(m_ui->actionClearRecentFiles, SIGNAL(triggered()), this, SLOT(actionClearRecentFiles()));
 	connect(m_ui->actionSave, SIGNAL(triggered()), this, SLOT(actionSave()));
 	connect(m_ui->actionSaveAs, SIGNAL(triggered()), this, SLOT(actionSaveAs()));
+	connect(m_ui->actionExportCompiled, SIGNAL(triggered()), this, SLOT(actionExportCompiled()));
 	connect(m_ui->actionExit, SIGNAL(triggered()), this, SLOT(close()));
+	connect(m_ui->actionUndo, SIGNAL(triggered()), m_history, SLOT(undo()));
+	connect(m_ui->actionRedo, SIGNAL(triggered()), m_history, SLOT(redo()));
 	connect(m_ui->actionAdd, SIGNAL(triggered()), this, SLOT(addSubtitle()));
 	connect(m_ui->actionRemove, SIGNAL(triggered()), this, SLOT(removeSubtitle()));
 	connect(m_ui->actionPrevious, SIGNAL(triggered()), this, SLOT(previousSubtitle()));
 	connect(m_ui->actionNext, SIGNAL(triggered()), this, SLOT(nextSubtitle()));
 	connect(m_ui->actionRescale, SIGNAL(triggered()), this, SLOT(rescaleSubtitles()));
+	connect(m_ui->actionSuggestTimes, SIGNAL(triggered()), this, SLOT(suggestTimes()));
+	connect(m_ui->actionSnapToSpeech, SIGNAL(triggered()), this, SLOT(snapToSpeech()));
 	connect(m_ui->actionPlayPause, SIGNAL(triggered()), this, SLOT(playPause()));
 	connect(m_ui->actionStop, SIGNAL(triggered()), m_mediaPlayer, SLOT(stop()));
 	connect(m_ui->actionAboutQt, SIGNAL(triggered()), QApplication::instance(), SLOT(aboutQt()));
 	connect(m_ui->actionAboutApplication, SIGNAL(triggered()), this, SLOT(actionAboutApplication()));
-	connect(m_ui->seekSlider, SIGNAL(sliderMoved(int)), this, SLOT(seek(int)));
+	connect(m_ui->seekSlider, SIGNAL(sliderMoved(int)), this, SLOT(scrub(int)));
+	connect(m_ui->seekSlider, SIGNAL(sliderReleased()), this, SLOT(finishScrubbing()));
 	connect(m_ui->volumeSlider, SIGNAL(sliderMoved(int)), m_mediaPlayer, SLOT(setVolume(int)));
-	connect(tabBar, SIGNAL(currentChanged(int)), this, SLOT(selectTrack(int)));
+	connect(m_tabBar, SIGNAL(currentChanged(int)), this, SLOT(selectTrack(int)));
 	connect(m_mediaPlayer, SIGNAL(error(QMediaPlayer::Error)), this, SLOT(errorOccured(QMediaPlayer::Error)));
 	connect(m_mediaPlayer, SIGNAL(stateChanged(QMediaPlayer::State)), this, SLOT(stateChanged(QMediaPlayer::State)));
 	connect(m_mediaPlayer, SIGNAL(durationChanged(qint64)), this, SLOT(durationChanged(qint64)));
-	connect(m_mediaPlayer, SIGNAL(positionChanged(qint64)), this, SLOT(positionChanged(qint64)));
+	connect(m_mediaPlayer, SIGNAL(positionChanged(qint64)), m_clock, SLOT(anchor(qint64)));
+	connect(m_mediaPlayer, SIGNAL(playbackRateChanged(qreal)), m_clock, SLOT(setPlaybackRate(qreal)));
+	connect(m_clock, SIGNAL(positionChanged(qint64)), this, SLOT(positionChanged(qint64)));
 	connect(m_mediaPlayer, SIGNAL(volumeChanged(int)), this, SLOT(updateAudio()));
+	connect(m_history, SIGNAL(canUndoChanged(bool)), m_ui->actionUndo, SLOT(setEnabled(bool)));
+	connect(m_history, SIGNAL(canRedoChanged(bool)), m_ui->actionRedo, SLOT(setEnabled(bool)));
+	connect(m_history, SIGNAL(subtitleChanged(int,int)), this, SLOT(historyChanged(int,int)));
+	connect(m_history, SIGNAL(modified()), this, SLOT(historyModified()));
+	connect(m_loader, SIGNAL(loaded(QString,QString,QList<LoadedTrack>)), this, SLOT(sequenceLoaded(QString,QString,QList<LoadedTrack>)));
+	connect(m_loader, SIGNAL(failed(QString)), this, SLOT(sequenceFailed(QString)));
+	connect(m_loader, SIGNAL(progressChanged(int,int)), this, SLOT(loadingProgressChanged(int,int)));
+	connect(m_fileWatcher, SIGNAL(fileChanged(QString)), this, SLOT(trackFileChanged(QString)));
+	connect(m_reloadTimer, SIGNAL(timeout()), this, SLOT(reloadChangedTracks()));
+	connect(m_indexer, SIGNAL(catalogChanged()), this, SLOT(updateSequences()));
+	connect(m_indexer, SIGNAL(searchIndexChanged()), this, SLOT(updateSearchIndex()));
+	connect(m_indexer, SIGNAL(runningChanged(bool)), m_sequencesBrowser, SLOT(setBusy(bool)));
+	connect(m_sequencesBrowser, SIGNAL(rootRequested()), this, SLOT(actionOpenSequences()));
+	connect(m_sequencesBrowser, SIGNAL(sequenceActivated(QString)), this, SLOT(actionOpen(QString)));
+	connect(m_searchBrowser, SIGNAL(hitActivated(QString,int,int,qint64)), this, SLOT(openSearchHit(QString,int,int,qint64)));
+	connect(m_mediaPlayer, SIGNAL(durationChanged(qint64)), m_timeline, SLOT(setDuration(qint64)));
+	connect(m_clock, SIGNAL(positionChanged(qint64)), m_timeline, SLOT(setPosition(qint64)));
+	connect(m_history, SIGNAL(subtitlesChanged(int,int,int)), m_timeline, SLOT(subtitlesChanged(int,int,int)));
+	connect(m_history, SIGNAL(subtitleInserted(int,int)), m_timeline, SLOT(trackChanged(int)));
+	connect(m_history, SIGNAL(subtitleRemoved(int,int)), m_timeline, SLOT(trackChanged(int)));
+	connect(m_waveformLoader, SIGNAL(peaksChanged()), m_timeline, SLOT(waveformChanged()));
+	connect(m_waveformLoader, SIGNAL(speechDetected()), this, SLOT(updateActions()));
+	connect(m_timeline, SIGNAL(positionRequested(int)), this, SLOT(seek(int)));
+	connect(m_timeline, SIGNAL(subtitleSelected(int,int)), this, SLOT(selectTimelineSubtitle(int,int)));
+	connect(m_timeline, SIGNAL(subtitleRetimed(int,int,qint64,qint64)), this, SLOT(retimeSubtitle(int,int,qint64,qint64)));
+	connect(m_timeline, SIGNAL(retimeFinished()), m_history, SLOT(seal()));
+	connect(m_subtitlesTable, SIGNAL(subtitleSelected(int,int)), this, SLOT(selectTimelineSubtitle(int,int)));
+	connect(m_history, SIGNAL(subtitlesChanged(int,int,int)), this, SLOT(updateCurrentSubtitle(int,int,int)));
+	connect(m_subtitlesModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)), this, SLOT(updateProblems()));
+	connect(m_subtitlesModel, SIGNAL(modelReset()), this, SLOT(updateProblems()));
+
+	const QString sequencesRoot = QSettings().value("Sequences/root").toString();
+
+	if (!sequencesRoot.isEmpty() && QFileInfo(sequencesRoot).isDir())
+	{
+		m_indexer->start(sequencesRoot);
+	}
 }
 
 MainWindow::~MainWindow()
@@ -181,19 +333,26 @@ void MainWindow::closeEvent(QCloseEvent *event)
 	settings.setValue("Window/state", saveState());
 	settings.setValue("Player/volume", m_mediaPlayer->volume());
 
+	m_journal->clear();
+
 	event->accept();
 }
 
 void MainWindow::actionOpen(QString fileName)
 {
-	if (isWindowModified() && QMessageBox::warning(this, tr("Question"), tr("Do you really want to close current subtitles without saving?"), QMessageBox::Yes | QMessageBox::No) == QMessageBox::No)
+	if (isWindowModified())
 	{
-		return;
+		if (QMessageBox::warning(this, tr("Question"), tr("Do you really want to close current subtitles without saving?"), QMessageBox::Yes | QMessageBox::No) == QMessageBox::No)
+		{
+			return;
+		}
+
+		m_journal->clear();
 	}
 
 	if (fileName.isEmpty())
 	{
-		fileName = QFileDialog::getOpenFileName(this, tr("Open Video or Subtitle file"), QSettings().value("lastUsedDir", QStandardPaths::standardLocations(QStandardPaths::HomeLocation).first()).toString(), tr("Video and subtitle files (*.txt *.txa *.og?)"));
+		fileName = QFileDialog::getOpenFileName(this, tr("Open Video or Subtitle file"), QSettings().value("lastUsedDir", QStandardPaths::standardLocations(QStandardPaths::HomeLocation).first()).toString(), tr("Video and subtitle files (*.txt *.txa *.bin *.og?)"));
 	}
 
 	if (fileName.isEmpty())
@@ -201,15 +360,7 @@ void MainWindow::actionOpen(QString fileName)
 		return;
 	}
 
-	if (!openFile(fileName))
-	{
-		QMessageBox::warning(this, tr("Error"), tr("Can not open sequence files."));
-	}
-
-	selectSubtitle();
-	updateActions();
-
-	m_ui->seekSlider->setValue(0);
+	openFile(fileName);
 }
 
 void MainWindow::actionOpenRecent(QAction *action)
@@ -220,6 +371,20 @@ void MainWindow::actionOpenRecent(QAction *action)
 	}
 }
 
+void MainWindow::actionOpenSequences()
+{
+	const QString root = QFileDialog::getExistingDirectory(this, tr("Open Sequences Directory"), QSettings().value("Sequences/root", QStandardPaths::standardLocations(QStandardPaths::HomeLocation).first()).toString());
+
+	if (root.isEmpty())
+	{
+		return;
+	}
+
+	QSettings().setValue("Sequences/root", root);
+
+	m_indexer->start(root);
+}
+
 void MainWindow::actionClearRecentFiles()
 {
 	QSettings().remove("recentFiles");
@@ -253,6 +418,16 @@ void MainWindow::actionSaveAs()
 	}
 }
 
+void MainWindow::actionExportCompiled()
+{
+	const QString fileName = QFileDialog::getSaveFileName(this, tr("Export Compiled Subtitles"), (m_currentPath.isEmpty() ? QStandardPaths::standardLocations(QStandardPaths::HomeLocation).first() : m_currentPath), tr("Compiled subtitles (*.bin)"));
+
+	if (!fileName.isEmpty())
+	{
+		exportCompiled(fileName);
+	}
+}
+
 void MainWindow::actionAboutApplication()
 {
 	QMessageBox::about(this, tr("About Subtitles Editor"), QString(tr("<b>Subtitles Editor %1</b><br>Subtitles previewer and editor for Warzone 2100.").arg(QApplication::instance()->applicationVersion())));
@@ -270,6 +445,8 @@ void MainWindow::stateChanged(QMediaPlayer::State state)
 	switch (state)
 	{
 		case QMediaPlayer::StoppedState:
+			m_clock->setRunning(false);
+			m_clock->anchor(0);
 			m_ui->actionPlayPause->setText(tr("Play"));
 			m_ui->actionPlayPause->setIcon(QIcon::fromTheme("media-playback-play", style()->standardIcon(QStyle::SP_MediaPlay)));
 			m_ui->actionStop->setEnabled(false);
@@ -278,12 +455,20 @@ void MainWindow::stateChanged(QMediaPlayer::State state)
 			m_ui->seekSlider->setToolTip(QString());
 			m_subtitlesTopWidget->setHtml(QString());
 			m_subtitlesBottomWidget->setHtml(QString());
+
+			for (int i = 0; i < m_subtitles.count(); ++i)
+			{
+				m_subtitles[i].invalidate();
+			}
+
 			m_videoWidget->hide();
 
 			emit timeChanged(QString("00:00.0 / %1").arg(timeToString(m_mediaPlayer->duration(), true)));
 
 			break;
 		case QMediaPlayer::PlayingState:
+			m_clock->anchor(m_mediaPlayer->position());
+			m_clock->setRunning(true);
 			m_ui->actionPlayPause->setText(tr("Pause"));
 			m_ui->actionPlayPause->setEnabled(true);
 			m_ui->actionPlayPause->setIcon(QIcon::fromTheme("media-playback-pause", style()->standardIcon(QStyle::SP_MediaPause)));
@@ -295,6 +480,8 @@ void MainWindow::stateChanged(QMediaPlayer::State state)
 
 			break;
 		case QMediaPlayer::PausedState:
+			m_clock->setRunning(false);
+			m_clock->anchor(m_mediaPlayer->position());
 			m_ui->actionPlayPause->setText(tr("Play"));
 			m_ui->actionPlayPause->setEnabled(true);
 			m_ui->actionPlayPause->setIcon(QIcon::fromTheme("media-playback-play", style()->standardIcon(QStyle::SP_MediaPlay)));
@@ -308,47 +495,61 @@ void MainWindow::stateChanged(QMediaPlayer::State state)
 
 void MainWindow::durationChanged(qint64 duration)
 {
+	m_clock->setDuration(duration);
 	m_ui->seekSlider->setRange(0, duration);
 	m_ui->seekSlider->setToolTip(tr("Position: %1").arg(QString("%1 / %2").arg(timeToString(m_mediaPlayer->position(), true)).arg(timeToString(m_mediaPlayer->duration(), true))));
 }
 
 void MainWindow::positionChanged(qint64 position)
 {
-	m_ui->seekSlider->setValue(position);
+	SUBTITLES_TRACE("MainWindow::positionChanged");
+
+	if (!m_ui->seekSlider->isSliderDown())
+	{
+		m_ui->seekSlider->setValue(position);
+	}
 
-	QString currentBottomSubtitles;
-	QString currentTopSubtitles;
-	const QString message = QString("%1 / %2").arg(timeToString(m_mediaPlayer->position(), true)).arg(timeToString(m_mediaPlayer->duration(), true));
-	const QTime currentTime = QTime(0, 0, 0).addMSecs(m_mediaPlayer->position());
+	const QString message = QString("%1 / %2").arg(timeToString(position, true)).arg(timeToString(m_mediaPlayer->duration(), true));
 
 	emit timeChanged(message);
 
 	m_ui->seekSlider->setToolTip(tr("Position: %1").arg(message));
 
-	for (int i = 0; i < m_subtitles[0].count(); ++i)
+	const bool topChanged = m_subtitles[m_topTrack].seek(position);
+	const bool bottomChanged = m_subtitles[m_bottomTrack].seek(position);
+
+	if (topChanged)
 	{
-		if (m_subtitles[0].at(i).begin < currentTime && m_subtitles[0].at(i).end > currentTime)
+		const QVector<int> active = m_subtitles[m_topTrack].activeSubtitles();
+		QStringList currentTopSubtitles;
+
+		for (int i = 0; i < active.count(); ++i)
 		{
-			currentTopSubtitles.append(m_subtitles[0].at(i).text);
-			currentTopSubtitles.append("<br>");
+			currentTopSubtitles.append(m_subtitles[m_topTrack].text(active.at(i)));
 		}
+
+		m_subtitlesTopWidget->setHtml(currentTopSubtitles.join("<br>"));
 	}
 
-	for (int i = 0; i < m_subtitles[1].count(); ++i)
+	if (bottomChanged)
 	{
-		if (m_subtitles[1].at(i).begin < currentTime && m_subtitles[1].at(i).end > currentTime)
-		{
-			currentBottomSubtitles.append(m_subtitles[1].at(i).text);
-			currentBottomSubtitles.append("<br>");
+		const QVector<int> active = m_subtitles[m_bottomTrack].activeSubtitles();
+		QStringList currentBottomSubtitles;
 
-			m_currentSubtitle = i;
+		for (int i = 0; i < active.count(); ++i)
+		{
+			currentBottomSubtitles.append(m_subtitles[m_bottomTrack].text(active.at(i)));
 		}
-	}
 
-	selectSubtitle();
+		if (!active.isEmpty() && m_currentTrack == m_bottomTrack)
+		{
+			m_currentSubtitle = active.last();
+
+			selectSubtitle();
+		}
 
-	m_subtitlesTopWidget->setHtml(currentTopSubtitles.left(currentTopSubtitles.length() - 6));
-	m_subtitlesBottomWidget->setHtml(currentBottomSubtitles.left(currentBottomSubtitles.length() - 6));
+		m_subtitlesBottomWidget->setHtml(currentBottomSubtitles.join("<br>"));
+	}
 }
 
 void MainWindow::playPause()
@@ -365,16 +566,214 @@ void MainWindow::playPause()
 
 void MainWindow::seek(int position)
 {
-	m_mediaPlayer->setPosition(position);
+	m_seekScheduler->seek(position);
+	m_clock->anchor(position);
+}
+
+void MainWindow::scrub(int position)
+{
+	const QImage thumbnail = m_thumbnailLoader->thumbnail(position);
+
+	if (thumbnail.isNull())
+	{
+		m_thumbnailLabel->hide();
+
+		seek(position);
+
+		return;
+	}
+
+	m_thumbnailLabel->setPixmap(QPixmap::fromImage(thumbnail));
+	m_thumbnailLabel->adjustSize();
+
+	const int x = QStyle::sliderPositionFromValue(m_ui->seekSlider->minimum(), m_ui->seekSlider->maximum(), position, m_ui->seekSlider->width());
+
+	m_thumbnailLabel->move(m_ui->seekSlider->mapToGlobal(QPoint((x - (m_thumbnailLabel->width() / 2)), -(m_thumbnailLabel->height() + 4))));
+	m_thumbnailLabel->show();
+
+	m_ui->seekSlider->setToolTip(tr("Position: %1").arg(QString("%1 / %2").arg(timeToString(position, true)).arg(timeToString(m_mediaPlayer->duration(), true))));
+}
+
+void MainWindow::finishScrubbing()
+{
+	m_thumbnailLabel->hide();
+
+	seek(m_ui->seekSlider->value());
 }
 
 void MainWindow::selectTrack(int track)
 {
+	if (!ensureTrackLoaded(track))
+	{
+		m_tabBar->setCurrentIndex(m_currentTrack);
+
+		return;
+	}
+
 	m_currentSubtitle = 0;
 	m_currentTrack = track;
+	m_trackInformation[track].lastViewed = ++m_viewCounter;
+
+	if (m_trackInformation.at(track).placement == TopPlacement)
+	{
+		m_topTrack = track;
+	}
+	else
+	{
+		m_bottomTrack = track;
+	}
+
+	m_subtitles[track].invalidate();
+	m_subtitlesModel->setTrack(track);
 
 	selectSubtitle();
 	updateActions();
+	positionChanged(m_clock->position());
+	evictTracks();
+}
+
+bool MainWindow::ensureTrackLoaded(int track)
+{
+	if (track < 0 || track >= m_trackInformation.count())
+	{
+		return false;
+	}
+
+	if (m_trackInformation.at(track).loaded)
+	{
+		return true;
+	}
+
+	const LoadedTrack loadedTrack = SequencesLoader::loadTrack(m_trackInformation.at(track).fileName);
+
+	if (!loadedTrack.readable)
+	{
+		QMessageBox::warning(this, tr("Error"), tr("Can not read subtitle file:\n%1").arg(loadedTrack.fileName));
+
+		return false;
+	}
+
+	m_subtitles[track] = loadedTrack.track;
+	m_baseSubtitles[track] = loadedTrack.track;
+	m_trackInformation[track].modified = SequencesCatalog::modificationTime(loadedTrack.fileName);
+	m_trackInformation[track].checksum = SequencesCatalog::fileChecksum(loadedTrack.fileName);
+	m_trackInformation[track].loaded = true;
+
+	if (m_trackInformation.at(track).modified > 0 && !m_fileWatcher->files().contains(loadedTrack.fileName))
+	{
+		m_fileWatcher->addPath(loadedTrack.fileName);
+	}
+
+	m_timeline->tracksChanged();
+	m_subtitlesModel->tracksChanged();
+
+	if (!loadedTrack.errorString.isEmpty())
+	{
+		QMessageBox::warning(this, tr("Warning"), tr("Some lines of subtitle file were skipped:\n%1\n\n%2").arg(loadedTrack.fileName).arg(loadedTrack.errorString));
+	}
+
+	return true;
+}
+
+bool MainWindow::ensureTracksLoaded()
+{
+	for (int i = 0; i < m_trackInformation.count(); ++i)
+	{
+		if (!ensureTrackLoaded(i))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+QStringList MainWindow::trackFileNames() const
+{
+	QStringList fileNames;
+
+	for (int i = 0; i < m_trackInformation.count(); ++i)
+	{
+		fileNames.append(m_trackInformation.at(i).fileName);
+	}
+
+	return fileNames;
+}
+
+void MainWindow::evictTracks()
+{
+	const qint64 limit = (QSettings().value("Tracks/memoryLimit", 64).toLongLong() * 1024 * 1024);
+	qint64 usage = 0;
+	bool evicted = false;
+
+	for (int i = 0; i < m_subtitles.count(); ++i)
+	{
+		usage += m_subtitles.at(i).memoryUsage();
+	}
+
+	while (usage > limit)
+	{
+		int candidate = -1;
+
+		for (int i = 0; i < m_trackInformation.count(); ++i)
+		{
+			const TrackInformation &information = m_trackInformation.at(i);
+
+			if (!information.loaded || i == m_currentTrack || i == m_topTrack || i == m_bottomTrack || m_subtitles.at(i).isModified() || m_history->hasCommands(i))
+			{
+				continue;
+			}
+
+			if (candidate < 0 || information.lastViewed < m_trackInformation.at(candidate).lastViewed)
+			{
+				candidate = i;
+			}
+		}
+
+		if (candidate < 0)
+		{
+			break;
+		}
+
+		usage -= m_subtitles.at(candidate).memoryUsage();
+
+		m_subtitles[candidate] = SubtitlesTrack();
+		m_baseSubtitles[candidate] = SubtitlesTrack();
+		m_trackInformation[candidate].loaded = false;
+
+		if (m_fileWatcher->files().contains(m_trackInformation.at(candidate).fileName))
+		{
+			m_fileWatcher->removePath(m_trackInformation.at(candidate).fileName);
+		}
+
+		evicted = true;
+	}
+
+	if (evicted)
+	{
+		m_timeline->tracksChanged();
+	}
+}
+
+void MainWindow::updateTabs()
+{
+	m_tabBar->blockSignals(true);
+
+	while (m_tabBar->count() > 0)
+	{
+		m_tabBar->removeTab(0);
+	}
+
+	for (int i = 0; i < m_trackInformation.count(); ++i)
+	{
+		const TrackInformation &information = m_trackInformation.at(i);
+		const QString placement = ((information.placement == TopPlacement) ? tr("Top") : tr("Bottom"));
+
+		m_tabBar->addTab(information.language.isEmpty() ? placement : QString("%1 (%2)").arg(placement).arg(information.language));
+	}
+
+	m_tabBar->setCurrentIndex(m_currentTrack);
+	m_tabBar->blockSignals(false);
 }
 
 void MainWindow::addSubtitle()
@@ -382,7 +781,7 @@ void MainWindow::addSubtitle()
 	Subtitle subtitle;
 	subtitle.position = QPoint(20, 432);
 
-	m_subtitles[m_currentTrack].insert(m_currentSubtitle, subtitle);
+	m_history->insert(m_currentTrack, m_currentSubtitle, subtitle);
 
 	nextSubtitle();
 	updateActions();
@@ -394,7 +793,7 @@ void MainWindow::removeSubtitle()
 {
 	if (QMessageBox::question(this, tr("Remove Subtitle"), tr("Are you sure that you want to remove this subtitle?")))
 	{
-		m_subtitles[m_currentTrack].removeAt(m_currentSubtitle);
+		m_history->remove(m_currentTrack, m_currentSubtitle);
 
 		selectSubtitle();
 		updateActions();
@@ -419,13 +818,17 @@ void MainWindow::nextSubtitle()
 
 void MainWindow::selectSubtitle()
 {
+	SUBTITLES_TRACE("MainWindow::selectSubtitle");
+
 	disconnect(m_ui->subtitleTextEdit, SIGNAL(textChanged()), this, SLOT(updateSubtitle()));
 	disconnect(m_ui->xPositionSpinBox, SIGNAL(valueChanged(int)), this, SLOT(updateSubtitle()));
 	disconnect(m_ui->yPositionSpinBox, SIGNAL(valueChanged(int)), this, SLOT(updateSubtitle()));
-	disconnect(m_ui->beginTimeEdit, SIGNAL(timeChanged(QTime)), this, SLOT(updateSubtitle()));
-	disconnect(m_ui->lengthTimeEdit, SIGNAL(timeChanged(QTime)), this, SLOT(updateSubtitle()));
+	disconnect(m_ui->beginTimeEdit, SIGNAL(valueChanged(int)), this, SLOT(updateSubtitle()));
+	disconnect(m_ui->lengthTimeEdit, SIGNAL(valueChanged(int)), this, SLOT(updateSubtitle()));
 
-	if (m_currentTrack < 0 || m_currentTrack > 1)
+	m_history->seal();
+
+	if (m_currentTrack < 0 || m_currentTrack >= m_subtitles.count())
 	{
 		m_currentTrack = 0;
 	}
@@ -448,17 +851,19 @@ void MainWindow::selectSubtitle()
 
 	if (m_currentSubtitle < m_subtitles[m_currentTrack].count())
 	{
-		m_ui->subtitleTextEdit->setPlainText(m_subtitles[m_currentTrack].at(m_currentSubtitle).text);
-		m_ui->beginTimeEdit->setTime(m_subtitles[m_currentTrack].at(m_currentSubtitle).begin);
-		m_ui->lengthTimeEdit->setTime(QTime(0, 0, 0).addMSecs(m_subtitles[m_currentTrack].at(m_currentSubtitle).begin.msecsTo(m_subtitles[m_currentTrack].at(m_currentSubtitle).end)));
-		m_ui->xPositionSpinBox->setValue(m_subtitles[m_currentTrack].at(m_currentSubtitle).position.x());
-		m_ui->yPositionSpinBox->setValue(m_subtitles[m_currentTrack].at(m_currentSubtitle).position.y());
+		const Subtitle subtitle = m_subtitles[m_currentTrack].subtitle(m_currentSubtitle);
+
+		m_ui->subtitleTextEdit->setPlainText(subtitle.text);
+		m_ui->beginTimeEdit->setTime(subtitle.begin);
+		m_ui->lengthTimeEdit->setTime(subtitle.end - subtitle.begin);
+		m_ui->xPositionSpinBox->setValue(subtitle.position.x());
+		m_ui->yPositionSpinBox->setValue(subtitle.position.y());
 	}
 	else
 	{
 		m_ui->subtitleTextEdit->clear();
-		m_ui->beginTimeEdit->setTime(QTime(0, 0, 0));
-		m_ui->lengthTimeEdit->setTime(QTime(0, 0, 0));
+		m_ui->beginTimeEdit->setTime(0);
+		m_ui->lengthTimeEdit->setTime(0);
 		m_ui->xPositionSpinBox->setValue(0);
 		m_ui->yPositionSpinBox->setValue(0);
 	}
@@ -466,99 +871,300 @@ void MainWindow::selectSubtitle()
 	connect(m_ui->subtitleTextEdit, SIGNAL(textChanged()), this, SLOT(updateSubtitle()));
 	connect(m_ui->xPositionSpinBox, SIGNAL(valueChanged(int)), this, SLOT(updateSubtitle()));
 	connect(m_ui->yPositionSpinBox, SIGNAL(valueChanged(int)), this, SLOT(updateSubtitle()));
-	connect(m_ui->beginTimeEdit, SIGNAL(timeChanged(QTime)), this, SLOT(updateSubtitle()));
-	connect(m_ui->lengthTimeEdit, SIGNAL(timeChanged(QTime)), this, SLOT(updateSubtitle()));
+	connect(m_ui->beginTimeEdit, SIGNAL(valueChanged(int)), this, SLOT(updateSubtitle()));
+	connect(m_ui->lengthTimeEdit, SIGNAL(valueChanged(int)), this, SLOT(updateSubtitle()));
+
+	m_timeline->setCurrentSubtitle(m_currentTrack, m_currentSubtitle);
+	m_subtitlesTable->setCurrentSubtitle(m_currentTrack, m_currentSubtitle);
+
+	updateProblems();
 }
 
-void MainWindow::updateSubtitle()
+void MainWindow::selectTimelineSubtitle(int track, int subtitle)
 {
-	if (m_currentSubtitle == 0 && m_subtitles[m_currentTrack].count() == 0)
+	if (track != m_currentTrack)
 	{
-		Subtitle subtitle;
+		m_tabBar->setCurrentIndex(track);
+	}
+
+	m_currentSubtitle = subtitle;
+
+	selectSubtitle();
+}
 
-		m_subtitles[m_currentTrack].append(subtitle);
+void MainWindow::retimeSubtitle(int track, int subtitle, qint64 begin, qint64 end)
+{
+	if (track != m_currentTrack || subtitle != m_currentSubtitle)
+	{
+		selectTimelineSubtitle(track, subtitle);
 	}
 
-	m_subtitles[m_currentTrack][m_currentSubtitle].text = m_ui->subtitleTextEdit->toPlainText();
-	m_subtitles[m_currentTrack][m_currentSubtitle].position = QPoint(m_ui->xPositionSpinBox->value(), m_ui->yPositionSpinBox->value());
-	m_subtitles[m_currentTrack][m_currentSubtitle].begin = m_ui->beginTimeEdit->time();
-	m_subtitles[m_currentTrack][m_currentSubtitle].end = m_ui->beginTimeEdit->time().addMSecs(m_ui->lengthTimeEdit->time().msecsTo(QTime(0, 0, 0)));
+	Subtitle data = m_subtitles[track].subtitle(subtitle);
+	data.begin = begin;
+	data.end = end;
+
+	m_history->edit(track, subtitle, data);
+
+	m_ui->beginTimeEdit->blockSignals(true);
+	m_ui->lengthTimeEdit->blockSignals(true);
+	m_ui->beginTimeEdit->setTime(begin);
+	m_ui->lengthTimeEdit->setTime(end - begin);
+	m_ui->beginTimeEdit->blockSignals(false);
+	m_ui->lengthTimeEdit->blockSignals(false);
 
 	setWindowModified(true);
-	updateActions();
 }
 
-void MainWindow::rescaleSubtitles()
+void MainWindow::updateCurrentSubtitle(int track, int first, int last)
 {
-	bool ok = false;
-	double scale = QInputDialog::getDouble(this, tr("Rescale Subtitles"), tr("Insert time multiplier:"), 1, 0, 100, 5, &ok);
-
-	if (!ok)
+	if (track != m_currentTrack || m_currentSubtitle < first || m_currentSubtitle > last || m_currentSubtitle >= m_subtitles[track].count())
 	{
 		return;
 	}
 
-	for (int i = 0; i < m_subtitles[0].count(); ++i)
-	{
-		m_subtitles[0][i].begin = QTime(0, 0, 0).addMSecs(QTime(0, 0, 0).msecsTo(m_subtitles[0][i].begin) * scale);
-		m_subtitles[0][i].end = QTime(0, 0, 0).addMSecs(QTime(0, 0, 0).msecsTo(m_subtitles[0][i].end) * scale);
-	}
+	const Subtitle subtitle = m_subtitles[track].subtitle(m_currentSubtitle);
 
-	for (int i = 0; i < m_subtitles[1].count(); ++i)
+	m_ui->subtitleTextEdit->blockSignals(true);
+	m_ui->beginTimeEdit->blockSignals(true);
+	m_ui->lengthTimeEdit->blockSignals(true);
+	m_ui->xPositionSpinBox->blockSignals(true);
+	m_ui->yPositionSpinBox->blockSignals(true);
+
+	if (subtitle.text != m_ui->subtitleTextEdit->toPlainText())
 	{
-		m_subtitles[1][i].begin = QTime(0, 0, 0).addMSecs(QTime(0, 0, 0).msecsTo(m_subtitles[1][i].begin) * scale);
-		m_subtitles[1][i].end = QTime(0, 0, 0).addMSecs(QTime(0, 0, 0).msecsTo(m_subtitles[1][i].end) * scale);
+		m_ui->subtitleTextEdit->setPlainText(subtitle.text);
 	}
 
-	selectSubtitle();
+	m_ui->beginTimeEdit->setTime(subtitle.begin);
+	m_ui->lengthTimeEdit->setTime(subtitle.end - subtitle.begin);
+	m_ui->xPositionSpinBox->setValue(subtitle.position.x());
+	m_ui->yPositionSpinBox->setValue(subtitle.position.y());
+	m_ui->subtitleTextEdit->blockSignals(false);
+	m_ui->beginTimeEdit->blockSignals(false);
+	m_ui->lengthTimeEdit->blockSignals(false);
+	m_ui->xPositionSpinBox->blockSignals(false);
+	m_ui->yPositionSpinBox->blockSignals(false);
 }
 
-void MainWindow::updateAudio()
+void MainWindow::updateProblems()
 {
-	m_ui->volumeSlider->setToolTip(tr("Volume: %1%").arg(m_mediaPlayer->volume()));
+	const QStringList problems = SubtitlesLinter::describe((m_subtitlesModel->track() == m_currentTrack) ? m_subtitlesModel->problems(m_currentSubtitle) : SubtitlesLinter::NoProblem);
+
+	m_problemsLabel->setText(problems.join(QLatin1String("; ")));
+	m_problemsLabel->setVisible(!problems.isEmpty());
 }
 
-void MainWindow::updateVideo()
+void MainWindow::updateSubtitle()
 {
-	m_videoWidget->setSize(m_ui->graphicsView->size());
+	if (m_currentSubtitle == 0 && m_subtitles[m_currentTrack].count() == 0)
+	{
+		m_history->insert(m_currentTrack, 0, Subtitle());
+	}
 
-	m_ui->graphicsView->centerOn(m_videoWidget);
-	m_ui->graphicsView->scene()->setSceneRect(m_ui->graphicsView->rect());
+	Subtitle subtitle;
+	subtitle.text = m_ui->subtitleTextEdit->toPlainText();
+	subtitle.position = QPoint(m_ui->xPositionSpinBox->value(), m_ui->yPositionSpinBox->value());
+	subtitle.begin = m_ui->beginTimeEdit->time();
+	subtitle.end = (subtitle.begin + m_ui->lengthTimeEdit->time());
 
-	m_subtitlesTopWidget->setPos(5, 5);
-	m_subtitlesTopWidget->setTextWidth(m_ui->graphicsView->scene()->width() - 10);
+	m_history->edit(m_currentTrack, m_currentSubtitle, subtitle);
 
-	m_subtitlesBottomWidget->setPos(5, (m_ui->graphicsView->scene()->height()- 5 - m_subtitlesBottomWidget->shape().controlPointRect().height()));
-	m_subtitlesBottomWidget->setTextWidth(m_ui->graphicsView->scene()->width() - 10);
+	setWindowModified(true);
+	updateActions();
 }
 
-void MainWindow::updateActions()
+void MainWindow::rescaleSubtitles()
 {
-	const bool available = (!m_subtitles[0].isEmpty() || !m_subtitles[1].isEmpty());
+	const QVector<int> rows = m_subtitlesTable->selectedRows();
+	const bool hasSubtitle = (m_currentSubtitle < m_subtitles[m_currentTrack].count());
+	RetimeDialog dialog(!rows.isEmpty(), this);
 
-	m_ui->actionSave->setEnabled(available || isWindowModified());
-	m_ui->actionSaveAs->setEnabled(available || isWindowModified());
-	m_ui->actionPrevious->setEnabled(available && m_subtitles[m_currentTrack].count() > 1);
-	m_ui->actionNext->setEnabled(available && m_subtitles[m_currentTrack].count() > 1);
-	m_ui->actionRemove->setEnabled(available);
-	m_ui->actionRescale->setEnabled(available);
-}
+	if (hasSubtitle)
+	{
+		dialog.setAnchor(m_subtitles[m_currentTrack].begin(m_currentSubtitle), m_clock->position());
+	}
 
-void MainWindow::updateRecentFilesMenu()
-{
-	const QStringList recentFiles = QSettings().value("recentFiles").toStringList();
+	if (dialog.exec() != QDialog::Accepted)
+	{
+		return;
+	}
 
-	for (int i = 0; i < 10; ++i)
+	const SubtitlesRetimer retimer = dialog.retimer();
+
+	if (!retimer.isValid() || retimer.isIdentity())
 	{
-		if (i < recentFiles.count())
-		{
-			QFileInfo fileInfo(recentFiles.at(i));
+		return;
+	}
 
-			m_ui->menuOpenRecent->actions().at(i)->setText(QString("%1. %2 (%3)").arg(i + 1).arg(fileInfo.fileName()).arg(recentFiles.at(i)));
-			m_ui->menuOpenRecent->actions().at(i)->setData(recentFiles.at(i));
-			m_ui->menuOpenRecent->actions().at(i)->setVisible(true);
-		}
-		else
+	if (dialog.scope() == RetimeDialog::AllTracksScope)
+	{
+		if (!ensureTracksLoaded())
+		{
+			return;
+		}
+
+		m_history->transform(retimer.scale(), retimer.offset());
+	}
+	else
+	{
+		QVector<QPair<int, int> > ranges;
+
+		if (dialog.scope() == RetimeDialog::SelectionScope)
+		{
+			for (int i = 0; i < rows.count(); ++i)
+			{
+				int last = i;
+
+				while ((last + 1) < rows.count() && rows.at(last + 1) == (rows.at(last) + 1))
+				{
+					++last;
+				}
+
+				ranges.append(qMakePair(rows.at(i), rows.at(last)));
+
+				i = last;
+			}
+		}
+		else
+		{
+			ranges.append(qMakePair(((dialog.scope() == RetimeDialog::FollowingScope && hasSubtitle) ? m_currentSubtitle : 0), (m_subtitles[m_currentTrack].count() - 1)));
+		}
+
+		m_history->transform(m_currentTrack, ranges, retimer.scale(), retimer.offset());
+	}
+
+	setWindowModified(true);
+	selectSubtitle();
+}
+
+void MainWindow::suggestTimes()
+{
+	if (m_currentSubtitle >= m_subtitles[m_currentTrack].count())
+	{
+		return;
+	}
+
+	const QVector<SpeechSegment> segments = m_waveformLoader->speechSegments();
+	Subtitle subtitle = m_subtitles[m_currentTrack].subtitle(m_currentSubtitle);
+	const int segment = SpeechDetector::segmentAt(segments, subtitle.begin, subtitle.end);
+
+	if (segment < 0)
+	{
+		m_ui->statusBar->showMessage(tr("No speech found near this subtitle."), 5000);
+
+		return;
+	}
+
+	subtitle.begin = segments.at(segment).begin;
+	subtitle.end = segments.at(segment).end;
+
+	m_history->edit(m_currentTrack, m_currentSubtitle, subtitle);
+
+	setWindowModified(true);
+	selectSubtitle();
+}
+
+void MainWindow::snapToSpeech()
+{
+	QVector<qint64> begins = m_subtitles[m_currentTrack].beginTimes();
+	QVector<qint64> ends = m_subtitles[m_currentTrack].endTimes();
+
+	SpeechDetector::snap(m_waveformLoader->speechSegments(), &begins, &ends);
+
+	if (begins == m_subtitles[m_currentTrack].beginTimes() && ends == m_subtitles[m_currentTrack].endTimes())
+	{
+		m_ui->statusBar->showMessage(tr("All subtitles are already aligned with speech."), 5000);
+
+		return;
+	}
+
+	m_history->retime(m_currentTrack, begins, ends);
+
+	setWindowModified(true);
+	selectSubtitle();
+}
+
+void MainWindow::historyChanged(int track, int subtitle)
+{
+	if (track >= 0 && track != m_currentTrack && track < m_tabBar->count())
+	{
+		m_tabBar->setCurrentIndex(track);
+	}
+
+	if (track == m_currentTrack && subtitle >= 0)
+	{
+		m_currentSubtitle = subtitle;
+	}
+
+	setWindowModified(true);
+	selectSubtitle();
+	updateActions();
+}
+
+void MainWindow::historyModified()
+{
+	if (!isWindowModified())
+	{
+		setWindowModified(true);
+		updateActions();
+	}
+}
+
+void MainWindow::updateAudio()
+{
+	m_ui->volumeSlider->setToolTip(tr("Volume: %1%").arg(m_mediaPlayer->volume()));
+}
+
+void MainWindow::updateVideo()
+{
+	SUBTITLES_TRACE("MainWindow::updateVideo");
+
+	m_videoWidget->setSize(m_ui->graphicsView->size());
+
+	m_ui->graphicsView->centerOn(m_videoWidget);
+	m_ui->graphicsView->scene()->setSceneRect(m_ui->graphicsView->rect());
+
+	const QRectF area = m_ui->graphicsView->scene()->sceneRect().adjusted(5, 5, -5, -5);
+
+	m_subtitlesTopWidget->setArea(area);
+	m_subtitlesBottomWidget->setArea(area);
+}
+
+void MainWindow::updateActions()
+{
+	bool available = false;
+
+	for (int i = 0; i < m_subtitles.count() && !available; ++i)
+	{
+		available = !m_subtitles.at(i).isEmpty();
+	}
+
+	m_ui->actionSave->setEnabled(available || isWindowModified());
+	m_ui->actionSaveAs->setEnabled(available || isWindowModified());
+	m_ui->actionExportCompiled->setEnabled(available);
+	m_ui->actionPrevious->setEnabled(available && m_subtitles[m_currentTrack].count() > 1);
+	m_ui->actionNext->setEnabled(available && m_subtitles[m_currentTrack].count() > 1);
+	m_ui->actionRemove->setEnabled(available);
+	m_ui->actionRescale->setEnabled(available);
+	m_ui->actionSuggestTimes->setEnabled(available && !m_waveformLoader->speechSegments().isEmpty());
+	m_ui->actionSnapToSpeech->setEnabled(available && !m_waveformLoader->speechSegments().isEmpty());
+}
+
+void MainWindow::updateRecentFilesMenu()
+{
+	const QStringList recentFiles = QSettings().value("recentFiles").toStringList();
+
+	for (int i = 0; i < 10; ++i)
+	{
+		if (i < recentFiles.count())
+		{
+			QFileInfo fileInfo(recentFiles.at(i));
+
+			m_ui->menuOpenRecent->actions().at(i)->setText(QString("%1. %2 (%3)").arg(i + 1).arg(fileInfo.fileName()).arg(recentFiles.at(i)));
+			m_ui->menuOpenRecent->actions().at(i)->setData(recentFiles.at(i));
+			m_ui->menuOpenRecent->actions().at(i)->setVisible(true);
+		}
+		else
 		{
 			m_ui->menuOpenRecent->actions().at(i)->setVisible(false);
 		}
@@ -567,97 +1173,193 @@ void MainWindow::updateRecentFilesMenu()
 	m_ui->menuOpenRecent->setEnabled(recentFiles.count());
 }
 
-QString MainWindow::timeToString(qint64 time, bool readable)
+void MainWindow::updateSequences()
+{
+	m_sequencesBrowser->setCatalog(m_indexer->catalog());
+}
+
+void MainWindow::updateSearchIndex()
 {
-	QString string;
-	int fractions = (time / 100);
-	int seconds = (fractions / 10);
-	int minutes = 0;
+	m_searchBrowser->setIndex(m_indexer->searchIndex());
+}
+
+void MainWindow::openSearchHit(const QString &fileName, int track, int subtitle, qint64 begin)
+{
+	const QString path = SequencesCatalog::sequencePath(fileName);
 
-	if (readable)
+	if (QFileInfo(m_currentPath).absoluteFilePath() != path)
 	{
-		minutes = (seconds / 60);
+		m_pendingSearchHit.fileName = fileName;
+		m_pendingSearchHit.track = track;
+		m_pendingSearchHit.subtitle = subtitle;
+		m_pendingSearchHit.begin = begin;
 
-		if (minutes < 10)
+		actionOpen(fileName);
+
+		if (!m_loader->isLoading())
 		{
-			string.append('0');
+			m_pendingSearchHit = SearchHit();
 		}
 
-		string.append(QString::number(minutes));
-		string.append(':');
-
-		seconds = (seconds - (minutes * 60));
+		return;
+	}
 
-		if (seconds < 10)
+	for (int i = 0; i < m_trackInformation.count(); ++i)
+	{
+		if (QFileInfo(m_trackInformation.at(i).fileName).absoluteFilePath() == fileName)
 		{
-			string.append('0');
+			track = i;
+
+			break;
 		}
 	}
 
-	string.append(QString::number(seconds));
-	string.append('.');
+	if (m_tabBar->currentIndex() != track)
+	{
+		m_tabBar->setCurrentIndex(track);
+	}
+
+	m_currentSubtitle = subtitle;
 
-	fractions = (fractions - (seconds * 10) - (minutes * 600));
+	selectSubtitle();
+	seek(begin);
+}
 
-	string.append(QString::number(fractions));
+QString MainWindow::timeToString(qint64 time, bool readable)
+{
+	char buffer[32];
 
-	return string;
+	return QString::fromLatin1(buffer, SubtitlesWriter::formatTime(time, buffer, readable));
 }
 
-bool MainWindow::openFile(const QString &fileName)
+void MainWindow::openFile(const QString &fileName)
 {
-	if (!QFile::exists(fileName))
-	{
-		return false;
-	}
+	SUBTITLES_TRACE("MainWindow::openFile");
+
+	m_loadingFileName = fileName;
+	m_loader->load(SequencesCatalog::sequencePath(fileName.endsWith(".bin", Qt::CaseInsensitive) ? fileName.left(fileName.length() - 4) : fileName));
+}
 
-	m_currentPath = fileName.left(fileName.lastIndexOf('.'));
+void MainWindow::openMovie(const QString &fileName)
+{
+	QString title = QFileInfo(fileName).fileName();
+	title = title.left(title.indexOf('.'));
 
-	const QString oggFile = m_currentPath + ".ogg";
-	const QString ogmFile = m_currentPath + ".ogm";
-	const QString ogvFile = m_currentPath + ".ogv";
-	const QString txtFile = m_currentPath + ".txt";
-	const QString txaFile = m_currentPath + ".txa";
+	setWindowTitle(tr("%1 - %2[*]").arg("Subtitles Editor").arg(title));
 
-	m_subtitles[0].clear();
-	m_subtitles[1].clear();
+	emit fileChanged(title);
+	emit timeChanged(QString("00:00.0 / %1").arg(timeToString(m_mediaPlayer->duration(), true)));
+
+	m_mediaPlayer->setMedia(QUrl::fromLocalFile(fileName));
+	m_waveformLoader->load(fileName);
+	m_thumbnailLoader->load(fileName);
+
+	m_ui->actionPlayPause->setEnabled(true);
+}
 
-	if (QFile::exists(oggFile) && !openMovie(oggFile))
+void MainWindow::sequenceLoaded(const QString &path, const QString &mediaFile, const QList<LoadedTrack> &tracks)
+{
+	QList<SubtitlesTrack> subtitles;
+	QList<TrackInformation> trackInformation;
+
+	for (int i = 0; i < tracks.count(); ++i)
 	{
-		return false;
+		if (tracks.at(i).loaded && !tracks.at(i).readable)
+		{
+			m_loadingFileName.clear();
+			m_pendingSearchHit = SearchHit();
+
+			QMessageBox::warning(this, tr("Error"), tr("Can not read subtitle file:\n%1").arg(tracks.at(i).fileName));
+
+			return;
+		}
+
+		TrackInformation information;
+		information.fileName = tracks.at(i).fileName;
+		information.language = tracks.at(i).language;
+		information.placement = tracks.at(i).placement;
+		information.modified = (tracks.at(i).loaded ? SequencesCatalog::modificationTime(tracks.at(i).fileName) : 0);
+		information.checksum = (tracks.at(i).loaded ? SequencesCatalog::fileChecksum(tracks.at(i).fileName) : QByteArray());
+		information.loaded = tracks.at(i).loaded;
+
+		subtitles.append(tracks.at(i).track);
+		trackInformation.append(information);
 	}
 
-	if (QFile::exists(ogmFile) && !openMovie(ogmFile))
+	if (!mediaFile.isEmpty())
 	{
-		return false;
+		openMovie(mediaFile);
 	}
 
-	if (QFile::exists(ogvFile) && !openMovie(ogvFile))
+	m_history->clear();
+	m_baseSubtitles = subtitles;
+	m_subtitles.swap(subtitles);
+	m_trackInformation = trackInformation;
+	m_currentPath = path;
+	m_currentTrack = 1;
+	m_topTrack = 0;
+	m_bottomTrack = 1;
+	m_changedTracks.clear();
+
+	if (!m_fileWatcher->files().isEmpty())
 	{
-		return false;
+		m_fileWatcher->removePaths(m_fileWatcher->files());
 	}
 
-	if (QFile::exists(txaFile) && !openSubtitles(txaFile, 0))
+	for (int i = 0; i < m_trackInformation.count(); ++i)
 	{
-		return false;
+		if (m_trackInformation.at(i).modified > 0)
+		{
+			m_fileWatcher->addPath(m_trackInformation.at(i).fileName);
+		}
 	}
 
-	if (QFile::exists(txtFile) && !openSubtitles(txtFile, 1))
+	m_journal->clear();
+	m_journal->setPath(path);
+
+	m_journal->setTracks(trackFileNames());
+
+	const int records = SubtitlesJournal::recordCount(path, trackFileNames());
+	bool recovered = false;
+
+	if (records > 0 && QMessageBox::question(this, tr("Recover Changes"), tr("Unsaved changes to this sequence were found (%n edit(s)).\nDo you want to restore them?", "", records), QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes)
 	{
-		return false;
+		if (ensureTracksLoaded())
+		{
+			recovered = (SubtitlesJournal::replay(path, &m_subtitles, trackFileNames()) > 0);
+
+			m_journal->clear();
+
+			for (int i = 0; i < m_subtitles.count(); ++i)
+			{
+				if (m_subtitles[i].isModified())
+				{
+					m_journal->recordTrack(i, m_subtitles[i]);
+				}
+			}
+		}
 	}
+	else if (QFile::exists(SubtitlesJournal::journalPath(path)))
+	{
+		m_journal->clear();
+	}
+
+	updateTabs();
+
+	m_timeline->tracksChanged();
+	m_subtitlesModel->tracksChanged();
 
 	selectTrack(1);
 
-	QString title = QFileInfo(fileName).fileName();
+	QString title = QFileInfo(m_loadingFileName).fileName();
 	title = title.left(title.indexOf('.'));
 
 	emit fileChanged(title);
 
-	setWindowModified(false);
+	setWindowModified(recovered);
 	setWindowTitle(tr("%1 - %2[*]").arg("Subtitles Editor").arg(title));
 
-	QFileInfo fileInfo(fileName);
+	QFileInfo fileInfo(m_loadingFileName);
 	QStringList recentFiles = QSettings().value("recentFiles").toStringList();
 	recentFiles.removeAll(fileInfo.absoluteFilePath());
 	recentFiles.prepend(fileInfo.absoluteFilePath());
@@ -666,103 +1368,286 @@ bool MainWindow::openFile(const QString &fileName)
 	QSettings().setValue("recentFiles", recentFiles);
 	QSettings().setValue("lastUsedDir", fileInfo.dir().path());
 
-	return true;
-}
+	m_loadingFileName.clear();
 
-bool MainWindow::openMovie(const QString &fileName)
-{
-	QString title = QFileInfo(fileName).fileName();
-	title = title.left(title.indexOf('.'));
+	selectSubtitle();
+	updateActions();
 
-	setWindowTitle(tr("%1 - %2[*]").arg("Subtitles Editor").arg(title));
+	m_ui->seekSlider->setValue(0);
 
-	emit fileChanged(title);
-	emit timeChanged(QString("00:00.0 / %1").arg(timeToString(m_mediaPlayer->duration(), true)));
+	for (int i = 0; i < tracks.count(); ++i)
+	{
+		if (!tracks.at(i).errorString.isEmpty())
+		{
+			QMessageBox::warning(this, tr("Warning"), tr("Some lines of subtitle file were skipped:\n%1\n\n%2").arg(tracks.at(i).fileName).arg(tracks.at(i).errorString));
+		}
+	}
 
-	m_mediaPlayer->setMedia(QUrl::fromLocalFile(fileName));
+	if (!m_pendingSearchHit.fileName.isEmpty())
+	{
+		const SearchHit hit = m_pendingSearchHit;
 
-	m_ui->actionPlayPause->setEnabled(true);
+		m_pendingSearchHit = SearchHit();
 
-	return true;
+		if (hit.fileName.startsWith(QFileInfo(path).absoluteFilePath() + '.'))
+		{
+			openSearchHit(hit.fileName, hit.track, hit.subtitle, hit.begin);
+		}
+	}
 }
 
-bool MainWindow::openSubtitles(const QString &fileName, int index)
+void MainWindow::sequenceFailed(const QString &path)
 {
-	QFile file(fileName);
+	Q_UNUSED(path)
 
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-	{
-		QMessageBox::warning(this, tr("Error"), tr("Can not read subtitle file:\n%1").arg(fileName));
+	m_loadingFileName.clear();
+	m_pendingSearchHit = SearchHit();
 
-		return false;
+	QMessageBox::warning(this, tr("Error"), tr("Can not open sequence files."));
+}
+
+void MainWindow::trackFileChanged(const QString &fileName)
+{
+	for (int i = 0; i < m_trackInformation.count(); ++i)
+	{
+		if (fileName == m_trackInformation.at(i).fileName)
+		{
+			m_changedTracks.insert(i);
+		}
 	}
 
-	m_subtitles[index].clear();
+	m_reloadTimer->start();
+}
+
+void MainWindow::reloadChangedTracks()
+{
+	const QList<int> changedTracks = m_changedTracks.values();
+	QStringList reloadedFiles;
+	int conflicts = 0;
 
-	QTextStream textStream(&file);
+	m_changedTracks.clear();
 
-	while (!textStream.atEnd())
+	for (int i = 0; i < changedTracks.count(); ++i)
 	{
-		QString line = textStream.readLine().trimmed();
+		const int track = changedTracks.at(i);
+		const QString fileName = m_trackInformation.at(track).fileName;
+		const qint64 modified = SequencesCatalog::modificationTime(fileName);
 
-		if (line.isEmpty() || line.startsWith("//"))
+		if (!m_trackInformation.at(track).loaded)
 		{
 			continue;
 		}
 
-		QRegExp expression("(\\d+)\\s+(\\d+)\\s+([\\d\\.]+)\\s+([\\d\\.]+)\\s+_?\\(?\"(.+)\"\\)?");
+		if (modified > 0 && !m_fileWatcher->files().contains(fileName))
+		{
+			m_fileWatcher->addPath(fileName);
+		}
 
-		if (expression.exactMatch(line))
+		if (modified == 0)
 		{
-			QStringList capturedTexts = expression.capturedTexts();
-			Subtitle subtitle;
+			continue;
+		}
+
+		const QByteArray checksum = SequencesCatalog::fileChecksum(fileName);
+
+		if (checksum == m_trackInformation.at(track).checksum)
+		{
+			m_trackInformation[track].modified = modified;
+
+			continue;
+		}
+
+		const LoadedTrack loadedTrack = SequencesLoader::loadTrack(fileName);
+
+		if (!loadedTrack.readable)
+		{
+			continue;
+		}
+
+		if (m_subtitles[track].isModified())
+		{
+			SubtitlesMerge merge(m_baseSubtitles[track], m_subtitles[track], loadedTrack.track);
 
-			subtitle.text = capturedTexts.value(5);
-			subtitle.begin = QTime(0, 0, 0).addMSecs(capturedTexts.value(3).toFloat() * 1000);
-			subtitle.end = QTime(0, 0, 0).addMSecs(capturedTexts.value(4).toFloat() * 1000);
-			subtitle.position = QPoint(capturedTexts.value(1).toInt(), capturedTexts.value(2).toInt());
+			m_subtitles[track] = merge.track();
 
-			m_subtitles[index].append(subtitle);
+			conflicts += merge.conflicts();
 		}
+		else
+		{
+			m_subtitles[track] = loadedTrack.track;
+		}
+
+		m_baseSubtitles[track] = loadedTrack.track;
+		m_trackInformation[track].checksum = checksum;
+		m_trackInformation[track].modified = modified;
+
+		reloadedFiles.append(QFileInfo(fileName).fileName());
 	}
 
-	file.close();
+	if (reloadedFiles.isEmpty())
+	{
+		return;
+	}
 
-	return true;
+	bool modified = false;
+
+	m_history->clear();
+	m_journal->clear();
+	m_timeline->tracksChanged();
+	m_subtitlesModel->tracksChanged();
+
+	for (int i = 0; i < m_subtitles.count(); ++i)
+	{
+		if (m_subtitles[i].isModified())
+		{
+			m_journal->recordTrack(i, m_subtitles[i]);
+
+			modified = true;
+		}
+	}
+
+	setWindowModified(modified);
+	selectSubtitle();
+	updateActions();
+
+	m_ui->statusBar->showMessage(tr("Reloaded from disk: %1").arg(reloadedFiles.join(", ")), 5000);
+
+	if (conflicts > 0)
+	{
+		QMessageBox::warning(this, tr("Warning"), tr("Subtitle files were changed on disk while you had unsaved changes.\n%n conflicting change(s) were resolved in favour of your local version.", "", conflicts));
+	}
+}
+
+void MainWindow::loadingProgressChanged(int value, int maximum)
+{
+	m_loadingProgressBar->setRange(0, maximum);
+	m_loadingProgressBar->setValue(value);
+	m_loadingProgressBar->setVisible(maximum > 0);
 }
 
 bool MainWindow::saveSubtitles(const QString &fileName)
 {
-	for (int i = 1; i >= 0; --i)
+	SUBTITLES_TRACE("MainWindow::saveSubtitles");
+
+	const QString basePath = (fileName.contains(QRegExp("\\.(txt|txa|ogg|ogm|ogv)$", Qt::CaseInsensitive)) ? SequencesCatalog::sequencePath(fileName) : fileName);
+	const bool currentPath = (QFileInfo(basePath).absoluteFilePath() == QFileInfo(m_currentPath).absoluteFilePath());
+	QVector<QString> paths(m_subtitles.count());
+	bool saved = true;
+
+	for (int i = (m_subtitles.count() - 1); i >= 0; --i)
 	{
-		if (m_subtitles[i].isEmpty())
+		if (!currentPath && !ensureTrackLoaded(i))
+		{
+			return false;
+		}
+
+		const TrackInformation information = m_trackInformation.at(i);
+		const QString path = basePath + (information.language.isEmpty() ? QString() : ('.' + information.language)) + ((information.placement == TopPlacement) ? ".txa" : ".txt");
+
+		paths[i] = path;
+
+		if (currentPath && !m_subtitles[i].isModified())
 		{
 			continue;
 		}
 
-		QString path = (fileName.contains(QRegExp("\\.(txt|txa|ogg|ogm|ogv)$", Qt::CaseInsensitive)) ? fileName.left(fileName.lastIndexOf('.')) : fileName) + (i ? ".txt" : ".txa");
-		QFile file(path);
+		if (m_subtitles[i].isEmpty())
+		{
+			if (currentPath && m_fileWatcher->files().contains(information.fileName))
+			{
+				m_fileWatcher->removePath(information.fileName);
+			}
+
+			if (QFile::exists(path) && !QFile::remove(path))
+			{
+				QMessageBox::warning(this, tr("Error"), tr("Can not remove subtitle file:\n%1").arg(path));
+
+				saved = false;
 
-		if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+				break;
+			}
+		}
+		else
 		{
-			QMessageBox::warning(this, tr("Error"), tr("Can not save subtitle file:\n%1").arg(path));
+			SubtitlesWriter writer;
 
-			return false;
+			if (!writer.writeFile(path, m_subtitles[i]))
+			{
+				QMessageBox::warning(this, tr("Error"), tr("Can not save subtitle file:\n%1").arg(path));
+
+				saved = false;
+
+				break;
+			}
 		}
 
-		QTextStream textStream(&file);
+		if (currentPath)
+		{
+			m_subtitles[i].setModified(false);
+			m_baseSubtitles[i] = m_subtitles[i];
+			m_trackInformation[i].modified = SequencesCatalog::modificationTime(path);
+			m_trackInformation[i].checksum = SequencesCatalog::fileChecksum(path);
+
+			if (m_trackInformation.at(i).modified > 0 && !m_fileWatcher->files().contains(information.fileName))
+			{
+				m_fileWatcher->addPath(information.fileName);
+			}
+		}
 
-		for (int j = 0; j < m_subtitles[i].count(); ++j)
+		m_indexer->updateTrack(path, i, m_subtitles[i]);
+	}
+
+	if (!saved)
+	{
+		if (currentPath)
 		{
-			textStream << QString("%1\t%2\t\t%3\t%4\t_(\"%5\")\n").arg(m_subtitles[i][j].position.x()).arg(m_subtitles[i][j].position.y()).arg(timeToString(QTime(0, 0, 0).msecsTo(m_subtitles[i][j].begin))).arg(timeToString(QTime(0, 0, 0).msecsTo(m_subtitles[i][j].end))).arg(m_subtitles[i][j].text);
+			bool modified = false;
+
+			m_journal->clear();
 
-			if ((j + 1) < m_subtitles[i].count() && m_subtitles[i][j].begin != m_subtitles[i][j + 1].begin)
+			for (int i = 0; i < m_subtitles.count(); ++i)
 			{
-				textStream << "\n";
+				if (m_subtitles[i].isModified())
+				{
+					m_journal->recordTrack(i, m_subtitles[i]);
+
+					modified = true;
+				}
 			}
+
+			setWindowModified(modified);
+			updateActions();
 		}
 
-		file.close();
+		return false;
+	}
+
+	if (!currentPath)
+	{
+		if (!m_fileWatcher->files().isEmpty())
+		{
+			m_fileWatcher->removePaths(m_fileWatcher->files());
+		}
+
+		for (int i = 0; i < m_subtitles.count(); ++i)
+		{
+			m_subtitles[i].setModified(false);
+			m_baseSubtitles[i] = m_subtitles[i];
+			m_trackInformation[i].fileName = paths.at(i);
+			m_trackInformation[i].modified = SequencesCatalog::modificationTime(paths.at(i));
+			m_trackInformation[i].checksum = SequencesCatalog::fileChecksum(paths.at(i));
+
+			if (m_trackInformation.at(i).modified > 0)
+			{
+				m_fileWatcher->addPath(paths.at(i));
+			}
+		}
+
+		m_currentPath = basePath;
+
+		m_journal->clear();
+		m_journal->setPath(basePath);
+		m_journal->setTracks(trackFileNames());
 	}
 
 	QString title = QFileInfo(fileName).fileName();
@@ -773,6 +1658,69 @@ bool MainWindow::saveSubtitles(const QString &fileName)
 	setWindowTitle(tr("%1 - %2[*]").arg("Subtitles Editor").arg(title));
 	setWindowModified(false);
 
+	m_journal->clear();
+	m_indexer->updateSequence(basePath);
+
+	return true;
+}
+
+bool MainWindow::exportCompiled(const QString &fileName)
+{
+	QString basePath = (fileName.endsWith(".bin", Qt::CaseInsensitive) ? fileName.left(fileName.length() - 4) : fileName);
+
+	if (basePath.contains(QRegExp("\\.(txt|txa|ogg|ogm|ogv)$", Qt::CaseInsensitive)))
+	{
+		basePath = SequencesCatalog::sequencePath(basePath);
+	}
+
+	int exported = 0;
+
+	if (!ensureTracksLoaded())
+	{
+		return false;
+	}
+
+	for (int i = 0; i < m_subtitles.count(); ++i)
+	{
+		if (m_subtitles[i].isEmpty())
+		{
+			continue;
+		}
+
+		const TrackInformation information = m_trackInformation.at(i);
+		const QString path = SubtitlesBinary::compiledFileName(basePath + (information.language.isEmpty() ? QString() : ('.' + information.language)) + ((information.placement == TopPlacement) ? ".txa" : ".txt"));
+		const QByteArray data = SubtitlesWriter().format(m_subtitles[i]);
+		SubtitlesParser parser;
+
+		if (!parser.parse(data.constData(), data.size()) || !parser.errors().isEmpty())
+		{
+			QMessageBox::warning(this, tr("Error"), tr("Can not convert subtitles to text format:\n%1").arg(parser.errorString()));
+
+			return false;
+		}
+
+		const SubtitlesTrack track = parser.track();
+		SubtitlesBinary binary;
+
+		if (!binary.writeFile(path, track, data))
+		{
+			QMessageBox::warning(this, tr("Error"), tr("Can not save compiled subtitle file:\n%1").arg(path));
+
+			return false;
+		}
+
+		if (!binary.open(path) || !binary.verify(track))
+		{
+			QMessageBox::warning(this, tr("Error"), tr("Compiled subtitle file does not match text format:\n%1").arg(path));
+
+			return false;
+		}
+
+		++exported;
+	}
+
+	m_ui->statusBar->showMessage(tr("Exported %n compiled track(s).", "", exported), 5000);
+
 	return true;
 }
 
@@ -21,25 +21,39 @@
 #ifndef SUBTITLESEDITOR_H
 #define SUBTITLESEDITOR_H
 
-#include <QtCore/QTime>
+#include "SearchIndex.h"
+#include "SequencesLoader.h"
+#include "SubtitlesTrack.h"
+
+#include <QtCore/QSet>
 #include <QtMultimedia/QMediaPlayer>
 #include <QtMultimediaWidgets/QGraphicsVideoItem>
 #include <QtWidgets/QMainWindow>
-#include <QtWidgets/QGraphicsTextItem>
 
 namespace Ui
 {
 	class MainWindow;
 }
 
-struct Subtitle
-{
-	QString text;
-	QTime begin;
-	QTime end;
-	QPoint position;
-};
+class QFileSystemWatcher;
+class QLabel;
+class QProgressBar;
+class QTabBar;
+class QTimer;
 
+class PlaybackClock;
+class SearchBrowser;
+class SeekScheduler;
+class SequencesBrowser;
+class SequencesIndexer;
+class SubtitlesHistory;
+class SubtitlesJournal;
+class SubtitlesModel;
+class SubtitlesOverlay;
+class SubtitlesTable;
+class SubtitlesTimeline;
+class ThumbnailLoader;
+class WaveformLoader;
 class SubtitlesWidget;
 
 class MainWindow : public QMainWindow
@@ -54,18 +68,24 @@ protected:
 	void changeEvent(QEvent *event);
 	void closeEvent(QCloseEvent *event);
 	QString timeToString(qint64 time, bool readable = false);
-	bool openFile(const QString &fileName);
-	bool openMovie(const QString &filename);
-	bool openSubtitles(const QString &fileName, int index);
+	void openFile(const QString &fileName);
 	bool saveSubtitles(const QString &fileName);
+	bool exportCompiled(const QString &fileName);
+	bool ensureTrackLoaded(int track);
+	bool ensureTracksLoaded();
+	QStringList trackFileNames() const;
+	void evictTracks();
+	void updateTabs();
 	bool eventFilter(QObject *object, QEvent *event);
 
 protected slots:
     void actionOpen(QString fileName = QString());
 	void actionOpenRecent(QAction *action);
+	void actionOpenSequences();
 	void actionClearRecentFiles();
 	void actionSave();
 	void actionSaveAs();
+	void actionExportCompiled();
 	void actionAboutApplication();
 	void errorOccured(QMediaPlayer::Error error);
 	void stateChanged(QMediaPlayer::State state);
@@ -73,29 +93,75 @@ protected slots:
 	void positionChanged(qint64 position);
 	void playPause();
 	void seek(int position);
+	void scrub(int position);
+	void finishScrubbing();
 	void selectTrack(int track);
 	void addSubtitle();
 	void removeSubtitle();
 	void previousSubtitle();
 	void nextSubtitle();
 	void selectSubtitle();
+	void selectTimelineSubtitle(int track, int subtitle);
+	void retimeSubtitle(int track, int subtitle, qint64 begin, qint64 end);
+	void updateCurrentSubtitle(int track, int first, int last);
+	void updateProblems();
 	void updateSubtitle();
 	void rescaleSubtitles();
+	void suggestTimes();
+	void snapToSpeech();
+	void historyChanged(int track, int subtitle);
+	void historyModified();
 	void updateAudio();
 	void updateVideo();
 	void updateActions();
 	void updateRecentFilesMenu();
+	void updateSequences();
+	void updateSearchIndex();
+	void openSearchHit(const QString &fileName, int track, int subtitle, qint64 begin);
+	void openMovie(const QString &fileName);
+	void sequenceLoaded(const QString &path, const QString &mediaFile, const QList<LoadedTrack> &tracks);
+	void sequenceFailed(const QString &path);
+	void loadingProgressChanged(int value, int maximum);
+	void trackFileChanged(const QString &fileName);
+	void reloadChangedTracks();
 
 private:
 	Ui::MainWindow *m_ui;
 	QMediaPlayer *m_mediaPlayer;
+	PlaybackClock *m_clock;
+	SeekScheduler *m_seekScheduler;
+	SubtitlesHistory *m_history;
+	SubtitlesJournal *m_journal;
+	SequencesIndexer *m_indexer;
+	SequencesLoader *m_loader;
+	WaveformLoader *m_waveformLoader;
+	ThumbnailLoader *m_thumbnailLoader;
+	SequencesBrowser *m_sequencesBrowser;
+	SearchBrowser *m_searchBrowser;
+	SubtitlesTimeline *m_timeline;
+	SubtitlesModel *m_subtitlesModel;
+	SubtitlesTable *m_subtitlesTable;
+	QTabBar *m_tabBar;
+	QProgressBar *m_loadingProgressBar;
+	QLabel *m_problemsLabel;
+	QLabel *m_thumbnailLabel;
+	QFileSystemWatcher *m_fileWatcher;
+	QTimer *m_reloadTimer;
 	QGraphicsVideoItem *m_videoWidget;
-	QGraphicsTextItem *m_subtitlesTopWidget;
-	QGraphicsTextItem *m_subtitlesBottomWidget;
+	SubtitlesOverlay *m_subtitlesTopWidget;
+	SubtitlesOverlay *m_subtitlesBottomWidget;
 	QString m_currentPath;
-	QList<QList<Subtitle> > m_subtitles;
+	QString m_loadingFileName;
+	SearchHit m_pendingSearchHit;
+	QList<SubtitlesTrack> m_subtitles;
+	QList<SubtitlesTrack> m_baseSubtitles;
+	QList<TrackInformation> m_trackInformation;
+	QSet<int> m_changedTracks;
 	int m_currentSubtitle;
 	int m_currentTrack;
+	int m_topTrack;
+	int m_bottomTrack;
+	int m_viewCounter;
 
 signals:
 	void timeChanged(QString time);
@@ -0,0 +1,660 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesHistory.h"
+#include "SubtitlesJournal.h"
+#include "SubtitlesRetimer.h"
+
+#include <algorithm>
+
+SubtitlesHistory::SubtitlesHistory(QList<SubtitlesTrack> *tracks, QObject *parent) : QObject(parent),
+	m_tracks(tracks),
+	m_journal(NULL),
+	m_memoryLimit(16 * 1024 * 1024),
+	m_memoryUsage(0),
+	m_index(0)
+{
+}
+
+void SubtitlesHistory::edit(int track, int subtitle, const Subtitle &data)
+{
+	if (subtitle < 0 || subtitle >= m_tracks->at(track).count())
+	{
+		return;
+	}
+
+	Command command;
+	command.type = EditCommand;
+	command.track = track;
+	command.subtitle = subtitle;
+	command.before = (*m_tracks)[track].subtitle(subtitle);
+	command.after = data;
+	command.scale = 1;
+	command.offset = 0;
+	command.sealed = false;
+
+	(*m_tracks)[track].setSubtitle(subtitle, data);
+
+	if (m_journal)
+	{
+		m_journal->recordSet(track, subtitle, data);
+	}
+
+	if (m_index > 0 && m_index == m_commands.count())
+	{
+		Command &top = m_commands.last();
+
+		if (top.type == EditCommand && !top.sealed && top.track == track && top.subtitle == subtitle)
+		{
+			m_memoryUsage -= commandSize(top);
+
+			top.after = data;
+
+			m_memoryUsage += commandSize(top);
+
+			enforceMemoryLimit();
+			emitChanges(top);
+
+			emit modified();
+			emit changed();
+
+			return;
+		}
+	}
+
+	push(command);
+}
+
+void SubtitlesHistory::edit(int track, const QVector<int> &subtitles, const QList<Subtitle> &data)
+{
+	if (subtitles.isEmpty() || subtitles.count() != data.count())
+	{
+		return;
+	}
+
+	for (int i = 0; i < subtitles.count(); ++i)
+	{
+		if (subtitles.at(i) < 0 || subtitles.at(i) >= m_tracks->at(track).count())
+		{
+			return;
+		}
+	}
+
+	Command command;
+	command.type = EditsCommand;
+	command.track = track;
+	command.subtitle = -1;
+	command.scale = 1;
+	command.offset = 0;
+	command.subtitles = subtitles;
+	command.afters = data;
+	command.sealed = true;
+
+	for (int i = 0; i < subtitles.count(); ++i)
+	{
+		command.befores.append(m_tracks->at(track).subtitle(subtitles.at(i)));
+
+		(*m_tracks)[track].setSubtitle(subtitles.at(i), data.at(i));
+
+		if (m_journal)
+		{
+			m_journal->recordSet(track, subtitles.at(i), data.at(i));
+		}
+	}
+
+	push(command);
+}
+
+void SubtitlesHistory::insert(int track, int subtitle, const Subtitle &data)
+{
+	Command command;
+	command.type = InsertCommand;
+	command.track = track;
+	command.subtitle = subtitle;
+	command.after = data;
+	command.scale = 1;
+	command.offset = 0;
+	command.sealed = true;
+
+	insertSubtitle(track, subtitle, data);
+	push(command);
+}
+
+void SubtitlesHistory::remove(int track, int subtitle)
+{
+	if (subtitle < 0 || subtitle >= m_tracks->at(track).count())
+	{
+		return;
+	}
+
+	Command command;
+	command.type = RemoveCommand;
+	command.track = track;
+	command.subtitle = subtitle;
+	command.before = (*m_tracks)[track].subtitle(subtitle);
+	command.scale = 1;
+	command.offset = 0;
+	command.sealed = true;
+
+	removeSubtitle(track, subtitle);
+	push(command);
+}
+
+void SubtitlesHistory::transform(double scale, double offset)
+{
+	Command command;
+	command.type = TransformCommand;
+	command.track = -1;
+	command.subtitle = -1;
+	command.scale = scale;
+	command.offset = offset;
+	command.sealed = true;
+
+	for (int i = 0; i < m_tracks->count(); ++i)
+	{
+		const SubtitlesTrack &track = m_tracks->at(i);
+
+		command.residues.append(transformResidues(track.begins(), 0, (track.count() - 1), scale, offset, 0) + transformResidues(track.ends(), 0, (track.count() - 1), scale, offset, 1));
+
+		(*m_tracks)[i].transform(scale, offset);
+	}
+
+	if (m_journal)
+	{
+		m_journal->recordTransform(scale, offset);
+	}
+
+	push(command);
+}
+
+void SubtitlesHistory::transform(int track, const QVector<QPair<int, int> > &ranges, double scale, double offset)
+{
+	Command command;
+	command.type = TransformCommand;
+	command.track = track;
+	command.subtitle = -1;
+	command.scale = scale;
+	command.offset = offset;
+	command.sealed = true;
+
+	SubtitlesTrack &target = (*m_tracks)[track];
+
+	for (int i = 0; i < ranges.count(); ++i)
+	{
+		const int first = qMax(0, ranges.at(i).first);
+		const int last = qMin(ranges.at(i).second, (target.count() - 1));
+
+		if (first > last)
+		{
+			continue;
+		}
+
+		command.ranges.append(qMakePair(first, last));
+		command.residues.append(transformResidues(target.begins(), first, last, scale, offset, 0) + transformResidues(target.ends(), first, last, scale, offset, 1));
+
+		target.transform(scale, offset, first, last);
+
+		if (m_journal)
+		{
+			m_journal->recordTransform(scale, offset, track, first, last);
+		}
+	}
+
+	if (command.ranges.isEmpty())
+	{
+		return;
+	}
+
+	push(command);
+}
+
+void SubtitlesHistory::retime(int track, const QVector<qint64> &begins, const QVector<qint64> &ends)
+{
+	Command command;
+	command.type = TimesCommand;
+	command.track = track;
+	command.subtitle = -1;
+	command.scale = 1;
+	command.offset = 0;
+	command.begins.append(m_tracks->at(track).beginTimes());
+	command.begins.append(begins);
+	command.ends.append(m_tracks->at(track).endTimes());
+	command.ends.append(ends);
+	command.sealed = true;
+
+	(*m_tracks)[track].setTimes(begins, ends);
+
+	if (m_journal)
+	{
+		m_journal->recordTimes(track, begins, ends);
+	}
+
+	push(command);
+}
+
+void SubtitlesHistory::undo()
+{
+	if (!canUndo())
+	{
+		return;
+	}
+
+	const bool couldRedo = canRedo();
+
+	--m_index;
+
+	m_commands[m_index].sealed = true;
+
+	apply(m_commands.at(m_index), true);
+	emitState(true, couldRedo);
+}
+
+void SubtitlesHistory::redo()
+{
+	if (!canRedo())
+	{
+		return;
+	}
+
+	const bool couldUndo = canUndo();
+
+	apply(m_commands.at(m_index), false);
+
+	++m_index;
+
+	emitState(couldUndo, true);
+}
+
+void SubtitlesHistory::seal()
+{
+	if (m_index > 0)
+	{
+		m_commands[m_index - 1].sealed = true;
+	}
+}
+
+void SubtitlesHistory::clear()
+{
+	const bool couldUndo = canUndo();
+	const bool couldRedo = canRedo();
+
+	m_commands.clear();
+	m_memoryUsage = 0;
+	m_index = 0;
+
+	emitState(couldUndo, couldRedo);
+
+	emit changed();
+}
+
+void SubtitlesHistory::push(const Command &command)
+{
+	const bool couldUndo = canUndo();
+	const bool couldRedo = canRedo();
+
+	seal();
+
+	while (m_commands.count() > m_index)
+	{
+		m_memoryUsage -= commandSize(m_commands.last());
+
+		m_commands.removeLast();
+	}
+
+	m_commands.append(command);
+
+	m_memoryUsage += commandSize(command);
+
+	++m_index;
+
+	enforceMemoryLimit();
+	emitState(couldUndo, couldRedo);
+	emitChanges(command);
+
+	emit modified();
+	emit changed();
+}
+
+void SubtitlesHistory::apply(const Command &command, bool reverse)
+{
+	switch (command.type)
+	{
+		case EditCommand:
+			(*m_tracks)[command.track].setSubtitle(command.subtitle, (reverse ? command.before : command.after));
+
+			if (m_journal)
+			{
+				m_journal->recordSet(command.track, command.subtitle, (reverse ? command.before : command.after));
+			}
+
+			break;
+		case InsertCommand:
+			if (reverse)
+			{
+				removeSubtitle(command.track, command.subtitle);
+			}
+			else
+			{
+				insertSubtitle(command.track, command.subtitle, command.after);
+			}
+
+			break;
+		case RemoveCommand:
+			if (reverse)
+			{
+				insertSubtitle(command.track, command.subtitle, command.before);
+			}
+			else
+			{
+				removeSubtitle(command.track, command.subtitle);
+			}
+
+			break;
+		case TransformCommand:
+			if (command.track < 0)
+			{
+				if (m_journal)
+				{
+					m_journal->recordTransform((reverse ? (1 / command.scale) : command.scale), (reverse ? (-command.offset / command.scale) : command.offset));
+				}
+
+				for (int i = 0; i < m_tracks->count(); ++i)
+				{
+					transformRange(command, i, 0, (m_tracks->at(i).count() - 1), command.residues.value(i), reverse);
+				}
+			}
+			else
+			{
+				for (int i = 0; i < command.ranges.count(); ++i)
+				{
+					if (m_journal)
+					{
+						m_journal->recordTransform((reverse ? (1 / command.scale) : command.scale), (reverse ? (-command.offset / command.scale) : command.offset), command.track, command.ranges.at(i).first, command.ranges.at(i).second);
+					}
+
+					transformRange(command, command.track, command.ranges.at(i).first, command.ranges.at(i).second, command.residues.value(i), reverse);
+				}
+			}
+
+			break;
+		case TimesCommand:
+			(*m_tracks)[command.track].setTimes(command.begins.at(reverse ? 0 : 1), command.ends.at(reverse ? 0 : 1));
+
+			if (m_journal)
+			{
+				m_journal->recordTimes(command.track, command.begins.at(reverse ? 0 : 1), command.ends.at(reverse ? 0 : 1));
+			}
+
+			break;
+		case EditsCommand:
+			for (int i = 0; i < command.subtitles.count(); ++i)
+			{
+				const int index = (reverse ? (command.subtitles.count() - i - 1) : i);
+				const Subtitle &data = (reverse ? command.befores.at(index) : command.afters.at(index));
+
+				(*m_tracks)[command.track].setSubtitle(command.subtitles.at(index), data);
+
+				if (m_journal)
+				{
+					m_journal->recordSet(command.track, command.subtitles.at(index), data);
+				}
+			}
+
+			break;
+		default:
+			break;
+	}
+
+	emitChanges(command);
+
+	emit subtitleChanged(command.track, command.subtitle);
+	emit changed();
+}
+
+void SubtitlesHistory::insertSubtitle(int track, int subtitle, const Subtitle &data)
+{
+	emit subtitleAboutToBeInserted(track, subtitle);
+
+	(*m_tracks)[track].insert(subtitle, data);
+
+	if (m_journal)
+	{
+		m_journal->recordInsert(track, subtitle, data);
+	}
+
+	emit subtitleInserted(track, subtitle);
+}
+
+void SubtitlesHistory::removeSubtitle(int track, int subtitle)
+{
+	emit subtitleAboutToBeRemoved(track, subtitle);
+
+	(*m_tracks)[track].remove(subtitle);
+
+	if (m_journal)
+	{
+		m_journal->recordRemove(track, subtitle);
+	}
+
+	emit subtitleRemoved(track, subtitle);
+}
+
+void SubtitlesHistory::transformRange(const Command &command, int track, int first, int last, const QVector<qint64> &residues, bool reverse)
+{
+	SubtitlesTrack &target = (*m_tracks)[track];
+
+	if (!reverse)
+	{
+		target.transform(command.scale, command.offset, first, last);
+
+		return;
+	}
+
+	target.transform((1 / command.scale), (-command.offset / command.scale), first, last);
+
+	for (int i = 0; i < residues.count(); i += 2)
+	{
+		const int subtitle = int(residues.at(i) / 2);
+
+		if (residues.at(i) % 2)
+		{
+			target.setTimes(subtitle, target.begin(subtitle), residues.at(i + 1));
+		}
+		else
+		{
+			target.setTimes(subtitle, residues.at(i + 1), target.end(subtitle));
+		}
+
+		if (m_journal)
+		{
+			m_journal->recordSet(track, subtitle, target.subtitle(subtitle));
+		}
+	}
+}
+
+void SubtitlesHistory::enforceMemoryLimit()
+{
+	while (m_memoryUsage > m_memoryLimit && m_index > 1)
+	{
+		m_memoryUsage -= commandSize(m_commands.first());
+
+		m_commands.removeFirst();
+
+		--m_index;
+	}
+}
+
+void SubtitlesHistory::emitState(bool couldUndo, bool couldRedo)
+{
+	if (couldUndo != canUndo())
+	{
+		emit canUndoChanged(canUndo());
+	}
+
+	if (couldRedo != canRedo())
+	{
+		emit canRedoChanged(canRedo());
+	}
+}
+
+void SubtitlesHistory::emitChanges(const Command &command)
+{
+	switch (command.type)
+	{
+		case EditCommand:
+			emit subtitlesChanged(command.track, command.subtitle, command.subtitle);
+
+			break;
+		case TransformCommand:
+			if (command.track >= 0)
+			{
+				for (int i = 0; i < command.ranges.count(); ++i)
+				{
+					emit subtitlesChanged(command.track, command.ranges.at(i).first, command.ranges.at(i).second);
+				}
+
+				break;
+			}
+
+			for (int i = 0; i < m_tracks->count(); ++i)
+			{
+				if (!m_tracks->at(i).isEmpty())
+				{
+					emit subtitlesChanged(i, 0, (m_tracks->at(i).count() - 1));
+				}
+			}
+
+			break;
+		case TimesCommand:
+			if (!m_tracks->at(command.track).isEmpty())
+			{
+				emit subtitlesChanged(command.track, 0, (m_tracks->at(command.track).count() - 1));
+			}
+
+			break;
+		case EditsCommand:
+			emit subtitlesChanged(command.track, *std::min_element(command.subtitles.constBegin(), command.subtitles.constEnd()), *std::max_element(command.subtitles.constBegin(), command.subtitles.constEnd()));
+
+			break;
+		default:
+			break;
+	}
+}
+
+void SubtitlesHistory::setJournal(SubtitlesJournal *journal)
+{
+	m_journal = journal;
+}
+
+void SubtitlesHistory::setMemoryLimit(qint64 limit)
+{
+	const bool couldUndo = canUndo();
+
+	m_memoryLimit = limit;
+
+	enforceMemoryLimit();
+	emitState(couldUndo, canRedo());
+}
+
+qint64 SubtitlesHistory::memoryLimit() const
+{
+	return m_memoryLimit;
+}
+
+qint64 SubtitlesHistory::memoryUsage() const
+{
+	return m_memoryUsage;
+}
+
+QVector<qint64> SubtitlesHistory::transformResidues(const qint64 *times, int first, int last, double scale, double offset, int kind)
+{
+	const int count = ((last - first) + 1);
+	QVector<qint64> residues;
+
+	if (count <= 0)
+	{
+		return residues;
+	}
+
+	QVector<qint64> transformed(count);
+
+	SubtitlesRetimer(scale, offset).apply((times + first), transformed.data(), count);
+	SubtitlesRetimer((1 / scale), (-offset / scale)).apply(transformed.data(), count);
+
+	for (int i = 0; i < count; ++i)
+	{
+		if (transformed.at(i) != times[first + i])
+		{
+			residues.append((qint64(first + i) * 2) + kind);
+			residues.append(times[first + i]);
+		}
+	}
+
+	return residues;
+}
+
+qint64 SubtitlesHistory::commandSize(const Command &command)
+{
+	qint64 size = (sizeof(Command) + ((command.before.text.size() + command.after.text.size()) * sizeof(QChar)));
+
+	for (int i = 0; i < command.begins.count(); ++i)
+	{
+		size += ((command.begins.at(i).count() + command.ends.at(i).count()) * sizeof(qint64));
+	}
+
+	for (int i = 0; i < command.residues.count(); ++i)
+	{
+		size += (command.residues.at(i).count() * sizeof(qint64));
+	}
+
+	size += (command.subtitles.count() * sizeof(int));
+	size += (command.ranges.count() * sizeof(QPair<int, int>));
+
+	for (int i = 0; i < command.befores.count(); ++i)
+	{
+		size += ((sizeof(Subtitle) * 2) + ((command.befores.at(i).text.size() + command.afters.at(i).text.size()) * sizeof(QChar)));
+	}
+
+	return size;
+}
+
+bool SubtitlesHistory::canUndo() const
+{
+	return (m_index > 0);
+}
+
+bool SubtitlesHistory::canRedo() const
+{
+	return (m_index < m_commands.count());
+}
+
+bool SubtitlesHistory::hasCommands(int track) const
+{
+	for (int i = 0; i < m_commands.count(); ++i)
+	{
+		if (m_commands.at(i).track == track || m_commands.at(i).type == TransformCommand)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
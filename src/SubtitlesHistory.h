@@ -0,0 +1,123 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESHISTORY_H
+#define SUBTITLESHISTORY_H
+
+#include "SubtitlesTrack.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QPair>
+
+class SubtitlesJournal;
+
+class SubtitlesHistory : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum CommandType
+	{
+		EditCommand = 0,
+		InsertCommand,
+		RemoveCommand,
+		TransformCommand,
+		TimesCommand,
+		EditsCommand
+	};
+
+	explicit SubtitlesHistory(QList<SubtitlesTrack> *tracks, QObject *parent = NULL);
+
+	void edit(int track, int subtitle, const Subtitle &data);
+	void edit(int track, const QVector<int> &subtitles, const QList<Subtitle> &data);
+	void insert(int track, int subtitle, const Subtitle &data);
+	void remove(int track, int subtitle);
+	void transform(double scale, double offset = 0);
+	void transform(int track, const QVector<QPair<int, int> > &ranges, double scale, double offset);
+	void retime(int track, const QVector<qint64> &begins, const QVector<qint64> &ends);
+	void setJournal(SubtitlesJournal *journal);
+	void setMemoryLimit(qint64 limit);
+	qint64 memoryLimit() const;
+	qint64 memoryUsage() const;
+	bool canUndo() const;
+	bool canRedo() const;
+	bool hasCommands(int track) const;
+
+public slots:
+	void undo();
+	void redo();
+	void seal();
+	void clear();
+
+protected:
+	struct Command
+	{
+		CommandType type;
+		int track;
+		int subtitle;
+		Subtitle before;
+		Subtitle after;
+		double scale;
+		double offset;
+		QList<QVector<qint64> > begins;
+		QList<QVector<qint64> > ends;
+		QList<QVector<qint64> > residues;
+		QVector<QPair<int, int> > ranges;
+		QVector<int> subtitles;
+		QList<Subtitle> befores;
+		QList<Subtitle> afters;
+		bool sealed;
+	};
+
+	void push(const Command &command);
+	void apply(const Command &command, bool reverse);
+	void insertSubtitle(int track, int subtitle, const Subtitle &data);
+	void removeSubtitle(int track, int subtitle);
+	void transformRange(const Command &command, int track, int first, int last, const QVector<qint64> &residues, bool reverse);
+	void enforceMemoryLimit();
+	void emitState(bool couldUndo, bool couldRedo);
+	void emitChanges(const Command &command);
+	static QVector<qint64> transformResidues(const qint64 *times, int first, int last, double scale, double offset, int kind);
+	static qint64 commandSize(const Command &command);
+
+private:
+	QList<SubtitlesTrack> *m_tracks;
+	SubtitlesJournal *m_journal;
+	QList<Command> m_commands;
+	qint64 m_memoryLimit;
+	qint64 m_memoryUsage;
+	int m_index;
+
+signals:
+	void canUndoChanged(bool canUndo);
+	void canRedoChanged(bool canRedo);
+	void subtitleChanged(int track, int subtitle);
+	void subtitlesChanged(int track, int first, int last);
+	void subtitleAboutToBeInserted(int track, int subtitle);
+	void subtitleInserted(int track, int subtitle);
+	void subtitleAboutToBeRemoved(int track, int subtitle);
+	void subtitleRemoved(int track, int subtitle);
+	void modified();
+	void changed();
+
+};
+
+#endif
@@ -0,0 +1,315 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesIndex.h"
+#include "Subtitle.h"
+#include "SubtitlesRetimer.h"
+
+#include <algorithm>
+#include <limits>
+
+static bool entryBeginLessThan(const SubtitlesIndex::Entry &entry, qint64 time)
+{
+	return (entry.begin < time);
+}
+
+static bool entryLessThan(const SubtitlesIndex::Entry &first, const SubtitlesIndex::Entry &second)
+{
+	return (first.begin < second.begin);
+}
+
+SubtitlesIndex::SubtitlesIndex() : m_windowBegin(0),
+	m_windowEnd(0),
+	m_treeValid(false),
+	m_windowValid(false),
+	m_activeValid(false)
+{
+}
+
+void SubtitlesIndex::clear()
+{
+	m_entries.clear();
+	m_boundaries.clear();
+	m_begins.clear();
+	m_ends.clear();
+	m_maximumEnds.clear();
+	m_active.clear();
+	m_treeValid = false;
+
+	invalidate();
+}
+
+void SubtitlesIndex::rebuild(const qint64 *begins, const qint64 *ends, int count)
+{
+	clear();
+
+	m_entries.reserve(count);
+	m_boundaries.reserve(count * 2);
+	m_begins.reserve(count);
+	m_ends.reserve(count);
+
+	for (int i = 0; i < count; ++i)
+	{
+		Entry entry;
+		entry.begin = begins[i];
+		entry.end = ends[i];
+		entry.subtitle = i;
+
+		m_entries.append(entry);
+		m_boundaries.append(entry.begin);
+		m_boundaries.append(entry.end);
+		m_begins.append(entry.begin);
+		m_ends.append(entry.end);
+	}
+
+	std::stable_sort(m_entries.begin(), m_entries.end(), entryLessThan);
+	std::sort(m_boundaries.begin(), m_boundaries.end());
+}
+
+void SubtitlesIndex::insert(int subtitle, qint64 begin, qint64 end)
+{
+	if (subtitle < m_begins.count())
+	{
+		for (int i = 0; i < m_entries.count(); ++i)
+		{
+			if (m_entries.at(i).subtitle >= subtitle)
+			{
+				++m_entries[i].subtitle;
+			}
+		}
+	}
+
+	Entry entry;
+	entry.begin = begin;
+	entry.end = end;
+	entry.subtitle = subtitle;
+
+	m_begins.insert(subtitle, begin);
+	m_ends.insert(subtitle, end);
+
+	insertEntry(entry);
+	invalidate();
+}
+
+void SubtitlesIndex::remove(int subtitle)
+{
+	if (subtitle < 0 || subtitle >= m_begins.count())
+	{
+		return;
+	}
+
+	removeEntry(subtitle);
+
+	m_begins.remove(subtitle);
+	m_ends.remove(subtitle);
+
+	for (int i = 0; i < m_entries.count(); ++i)
+	{
+		if (m_entries.at(i).subtitle > subtitle)
+		{
+			--m_entries[i].subtitle;
+		}
+	}
+
+	invalidate();
+}
+
+void SubtitlesIndex::update(int subtitle, qint64 begin, qint64 end)
+{
+	if (subtitle < 0 || subtitle >= m_begins.count())
+	{
+		return;
+	}
+
+	if (m_begins.at(subtitle) == begin && m_ends.at(subtitle) == end)
+	{
+		return;
+	}
+
+	removeEntry(subtitle);
+
+	Entry entry;
+	entry.begin = begin;
+	entry.end = end;
+	entry.subtitle = subtitle;
+
+	m_begins[subtitle] = begin;
+	m_ends[subtitle] = end;
+
+	insertEntry(entry);
+	invalidate();
+}
+
+void SubtitlesIndex::transform(double scale, double offset)
+{
+	for (int i = 0; i < m_entries.count(); ++i)
+	{
+		m_entries[i].begin = transformTime(m_entries.at(i).begin, scale, offset);
+		m_entries[i].end = transformTime(m_entries.at(i).end, scale, offset);
+	}
+
+	const SubtitlesRetimer retimer(scale, offset);
+
+	retimer.apply(m_boundaries.data(), m_boundaries.count());
+	retimer.apply(m_begins.data(), m_begins.count());
+	retimer.apply(m_ends.data(), m_ends.count());
+
+	m_treeValid = false;
+
+	invalidate();
+}
+
+bool SubtitlesIndex::seek(qint64 time)
+{
+	if (m_windowValid && time > m_windowBegin && time < m_windowEnd)
+	{
+		return false;
+	}
+
+	QVector<qint64>::const_iterator lower = std::lower_bound(m_boundaries.constBegin(), m_boundaries.constEnd(), time);
+	QVector<qint64>::const_iterator upper = std::upper_bound(lower, m_boundaries.constEnd(), time);
+
+	m_windowBegin = ((lower == m_boundaries.constBegin()) ? std::numeric_limits<qint64>::min() : *(lower - 1));
+	m_windowEnd = ((upper == m_boundaries.constEnd()) ? std::numeric_limits<qint64>::max() : *upper);
+	m_windowValid = (lower == upper);
+
+	if (!m_treeValid)
+	{
+		buildTree();
+	}
+
+	QVector<int> active;
+
+	if (!m_entries.isEmpty())
+	{
+		const int limit = (std::lower_bound(m_entries.constBegin(), m_entries.constEnd(), time, entryBeginLessThan) - m_entries.constBegin());
+
+		collectActive(1, 0, (m_maximumEnds.count() / 2), limit, time, &active);
+	}
+
+	std::sort(active.begin(), active.end());
+
+	if (m_activeValid && active == m_active)
+	{
+		return false;
+	}
+
+	m_active = active;
+	m_activeValid = true;
+
+	return true;
+}
+
+QVector<int> SubtitlesIndex::activeSubtitles() const
+{
+	return m_active;
+}
+
+void SubtitlesIndex::insertEntry(const Entry &entry)
+{
+	m_entries.insert(std::upper_bound(m_entries.begin(), m_entries.end(), entry, entryLessThan), entry);
+	m_boundaries.insert(std::upper_bound(m_boundaries.begin(), m_boundaries.end(), entry.begin), entry.begin);
+	m_boundaries.insert(std::upper_bound(m_boundaries.begin(), m_boundaries.end(), entry.end), entry.end);
+
+	m_treeValid = false;
+}
+
+void SubtitlesIndex::removeEntry(int subtitle)
+{
+	const qint64 begin = m_begins.at(subtitle);
+	const qint64 end = m_ends.at(subtitle);
+
+	for (QVector<Entry>::iterator iterator = std::lower_bound(m_entries.begin(), m_entries.end(), begin, entryBeginLessThan); iterator != m_entries.end() && iterator->begin == begin; ++iterator)
+	{
+		if (iterator->subtitle == subtitle)
+		{
+			m_entries.erase(iterator);
+
+			break;
+		}
+	}
+
+	QVector<qint64>::iterator beginBoundary = std::lower_bound(m_boundaries.begin(), m_boundaries.end(), begin);
+
+	if (beginBoundary != m_boundaries.end() && *beginBoundary == begin)
+	{
+		m_boundaries.erase(beginBoundary);
+	}
+
+	QVector<qint64>::iterator endBoundary = std::lower_bound(m_boundaries.begin(), m_boundaries.end(), end);
+
+	if (endBoundary != m_boundaries.end() && *endBoundary == end)
+	{
+		m_boundaries.erase(endBoundary);
+	}
+
+	m_treeValid = false;
+}
+
+void SubtitlesIndex::buildTree()
+{
+	int leaves = 1;
+
+	while (leaves < m_entries.count())
+	{
+		leaves *= 2;
+	}
+
+	m_maximumEnds.fill(std::numeric_limits<qint64>::min(), (leaves * 2));
+
+	for (int i = 0; i < m_entries.count(); ++i)
+	{
+		m_maximumEnds[leaves + i] = m_entries.at(i).end;
+	}
+
+	for (int i = (leaves - 1); i > 0; --i)
+	{
+		m_maximumEnds[i] = qMax(m_maximumEnds.at(i * 2), m_maximumEnds.at((i * 2) + 1));
+	}
+
+	m_treeValid = true;
+}
+
+void SubtitlesIndex::collectActive(int node, int first, int last, int limit, qint64 time, QVector<int> *active) const
+{
+	if (first >= limit || m_maximumEnds.at(node) <= time)
+	{
+		return;
+	}
+
+	if ((last - first) == 1)
+	{
+		active->append(m_entries.at(first).subtitle);
+
+		return;
+	}
+
+	const int middle = ((first + last) / 2);
+
+	collectActive((node * 2), first, middle, limit, time, active);
+	collectActive(((node * 2) + 1), middle, last, limit, time, active);
+}
+
+void SubtitlesIndex::invalidate()
+{
+	m_windowValid = false;
+	m_activeValid = false;
+}
@@ -0,0 +1,69 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESINDEX_H
+#define SUBTITLESINDEX_H
+
+#include <QtCore/QVector>
+
+class SubtitlesIndex
+{
+public:
+	struct Entry
+	{
+		qint64 begin;
+		qint64 end;
+		int subtitle;
+	};
+
+	SubtitlesIndex();
+
+	void clear();
+	void rebuild(const qint64 *begins, const qint64 *ends, int count);
+	void insert(int subtitle, qint64 begin, qint64 end);
+	void remove(int subtitle);
+	void update(int subtitle, qint64 begin, qint64 end);
+	void transform(double scale, double offset = 0);
+	bool seek(qint64 time);
+	void invalidate();
+	QVector<int> activeSubtitles() const;
+
+protected:
+	void insertEntry(const Entry &entry);
+	void removeEntry(int subtitle);
+	void buildTree();
+	void collectActive(int node, int first, int last, int limit, qint64 time, QVector<int> *active) const;
+
+private:
+	QVector<Entry> m_entries;
+	QVector<qint64> m_boundaries;
+	QVector<qint64> m_begins;
+	QVector<qint64> m_ends;
+	QVector<qint64> m_maximumEnds;
+	QVector<int> m_active;
+	qint64 m_windowBegin;
+	qint64 m_windowEnd;
+	bool m_treeValid;
+	bool m_windowValid;
+	bool m_activeValid;
+};
+
+#endif
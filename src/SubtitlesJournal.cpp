@@ -0,0 +1,530 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesJournal.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMap>
+#include <QtCore/QTimer>
+#include <QtCore/QtEndian>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const quint32 journalMagic = 0x575A534A;
+static const quint32 journalVersion = 2;
+static const quint32 maximumRecordSize = (64 * 1024 * 1024);
+
+static QByteArray encodeSubtitle(const Subtitle &data)
+{
+	QByteArray payload;
+	QDataStream stream(&payload, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << data.text << data.begin << data.end << data.position;
+
+	return payload;
+}
+
+SubtitlesJournal::SubtitlesJournal(QObject *parent) : QObject(parent),
+	m_flushTimer(new QTimer(this))
+{
+	m_flushTimer->setSingleShot(true);
+	m_flushTimer->setInterval(FlushInterval);
+
+	connect(m_flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+}
+
+SubtitlesJournal::~SubtitlesJournal()
+{
+	flush();
+}
+
+void SubtitlesJournal::setPath(const QString &path)
+{
+	if (path == m_path)
+	{
+		return;
+	}
+
+	flush();
+
+	m_file.close();
+	m_path = path;
+}
+
+void SubtitlesJournal::setTracks(const QStringList &fileNames)
+{
+	m_tracks.clear();
+
+	for (int i = 0; i < fileNames.count(); ++i)
+	{
+		m_tracks.append(trackName(fileNames.at(i)));
+	}
+}
+
+void SubtitlesJournal::recordSet(int track, int subtitle, const Subtitle &data)
+{
+	append(SetRecord, track, subtitle, encodeSubtitle(data));
+}
+
+void SubtitlesJournal::recordInsert(int track, int subtitle, const Subtitle &data)
+{
+	append(InsertRecord, track, subtitle, encodeSubtitle(data));
+}
+
+void SubtitlesJournal::recordRemove(int track, int subtitle)
+{
+	append(RemoveRecord, track, subtitle);
+}
+
+void SubtitlesJournal::recordTransform(double scale, double offset, int track, int first, int last)
+{
+	QByteArray payload;
+	QDataStream stream(&payload, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << scale << offset << qint32(last);
+
+	append(TransformRecord, track, first, payload);
+}
+
+void SubtitlesJournal::recordTimes(int track, const QVector<qint64> &begins, const QVector<qint64> &ends)
+{
+	QByteArray payload;
+	QDataStream stream(&payload, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << begins << ends;
+
+	append(TimesRecord, track, -1, payload);
+}
+
+void SubtitlesJournal::recordTrack(int track, const SubtitlesTrack &data)
+{
+	QByteArray payload;
+	QDataStream stream(&payload, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << qint32(data.count());
+
+	for (int i = 0; i < data.count(); ++i)
+	{
+		stream << data.text(i) << data.begin(i) << data.end(i) << data.position(i);
+	}
+
+	append(TrackRecord, track, -1, payload);
+}
+
+void SubtitlesJournal::append(RecordType type, int track, int subtitle, const QByteArray &payload)
+{
+	if (m_path.isEmpty())
+	{
+		return;
+	}
+
+	QByteArray record;
+	QDataStream stream(&record, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << quint8(type) << ((track >= 0 && track < m_tracks.count()) ? m_tracks.at(track) : QString()) << qint32(subtitle);
+
+	record.append(payload);
+
+	uchar header[6];
+
+	qToBigEndian<quint32>(record.size(), header);
+	qToBigEndian<quint16>(qChecksum(record.constData(), record.size()), (header + 4));
+
+	m_buffer.append(reinterpret_cast<const char*>(header), 6);
+	m_buffer.append(record);
+
+	if (m_buffer.size() >= FlushSize)
+	{
+		flush();
+	}
+	else if (!m_flushTimer->isActive())
+	{
+		m_flushTimer->start();
+	}
+}
+
+void SubtitlesJournal::flush()
+{
+	m_flushTimer->stop();
+
+	if (m_buffer.isEmpty() || m_path.isEmpty())
+	{
+		return;
+	}
+
+	if (!m_file.isOpen())
+	{
+		m_file.setFileName(journalPath(m_path));
+
+		if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append))
+		{
+			m_buffer.clear();
+
+			return;
+		}
+
+		if (m_file.size() == 0)
+		{
+			const QDir directory(QFileInfo(m_path).dir());
+			QMap<QString, qint64> modified;
+
+			for (int i = 0; i < m_tracks.count(); ++i)
+			{
+				modified[m_tracks.at(i)] = modificationTime(directory.filePath(m_tracks.at(i)));
+			}
+
+			QDataStream stream(&m_file);
+			stream.setVersion(QDataStream::Qt_5_0);
+			stream << journalMagic << journalVersion << modified;
+		}
+	}
+
+	m_file.write(m_buffer);
+	m_file.flush();
+
+#ifdef Q_OS_WIN
+	_commit(m_file.handle());
+#else
+	fsync(m_file.handle());
+#endif
+
+	m_buffer.clear();
+}
+
+void SubtitlesJournal::clear()
+{
+	m_flushTimer->stop();
+	m_buffer.clear();
+	m_file.close();
+
+	if (!m_path.isEmpty())
+	{
+		QFile::remove(journalPath(m_path));
+	}
+}
+
+QString SubtitlesJournal::path() const
+{
+	return m_path;
+}
+
+bool SubtitlesJournal::readHeader(QFile *file, const QString &path, QSet<QString> *tracks)
+{
+	QDataStream stream(file);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic = 0;
+	quint32 version = 0;
+
+	stream >> magic >> version;
+
+	if (stream.status() != QDataStream::Ok || magic != journalMagic || version != journalVersion)
+	{
+		return false;
+	}
+
+	QMap<QString, qint64> modified;
+
+	stream >> modified;
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		return false;
+	}
+
+	const QDir directory(QFileInfo(path).dir());
+
+	for (QMap<QString, qint64>::const_iterator iterator = modified.constBegin(); iterator != modified.constEnd(); ++iterator)
+	{
+		if (iterator.value() == modificationTime(directory.filePath(iterator.key())))
+		{
+			tracks->insert(iterator.key());
+		}
+	}
+
+	return true;
+}
+
+bool SubtitlesJournal::readRecord(QFile *file, QByteArray *record)
+{
+	const QByteArray header = file->read(6);
+
+	if (header.size() < 6)
+	{
+		return false;
+	}
+
+	const quint32 size = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(header.constData()));
+	const quint16 checksum = qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(header.constData() + 4));
+
+	if (size > maximumRecordSize)
+	{
+		return false;
+	}
+
+	*record = file->read(size);
+
+	return (record->size() == int(size) && qChecksum(record->constData(), size) == checksum);
+}
+
+int SubtitlesJournal::recordCount(const QString &path, const QStringList &fileNames)
+{
+	QFile file(journalPath(path));
+	QSet<QString> tracks;
+
+	if (!file.open(QIODevice::ReadOnly) || !readHeader(&file, path, &tracks))
+	{
+		return 0;
+	}
+
+	QStringList names;
+
+	for (int i = 0; i < fileNames.count(); ++i)
+	{
+		names.append(trackName(fileNames.at(i)));
+	}
+
+	QByteArray record;
+	int count = 0;
+
+	while (readRecord(&file, &record))
+	{
+		QDataStream stream(record);
+		stream.setVersion(QDataStream::Qt_5_0);
+
+		quint8 type = 0;
+		QString track;
+
+		stream >> type >> track;
+
+		if ((type == TransformRecord && track.isEmpty()) || (tracks.contains(track) && names.contains(track)))
+		{
+			++count;
+		}
+	}
+
+	return count;
+}
+
+int SubtitlesJournal::replay(const QString &path, QList<SubtitlesTrack> *tracks, const QStringList &fileNames)
+{
+	QFile file(journalPath(path));
+	QSet<QString> validTracks;
+
+	if (!file.open(QIODevice::ReadWrite) || !readHeader(&file, path, &validTracks))
+	{
+		return 0;
+	}
+
+	QStringList names;
+
+	for (int i = 0; i < fileNames.count(); ++i)
+	{
+		names.append(trackName(fileNames.at(i)));
+	}
+
+	QByteArray record;
+	qint64 validSize = file.pos();
+	int count = 0;
+
+	while (readRecord(&file, &record))
+	{
+		QDataStream stream(record);
+		stream.setVersion(QDataStream::Qt_5_0);
+
+		quint8 type = 0;
+		QString trackFile;
+		qint32 subtitle = 0;
+
+		stream >> type >> trackFile >> subtitle;
+
+		const int track = names.indexOf(trackFile);
+
+		if ((type != TransformRecord || !trackFile.isEmpty()) && (track < 0 || track >= tracks->count() || !validTracks.contains(trackFile)))
+		{
+			validSize = file.pos();
+
+			continue;
+		}
+
+		SubtitlesTrack *target = ((track < 0) ? NULL : &(*tracks)[track]);
+		bool applied = false;
+
+		switch (type)
+		{
+			case SetRecord:
+			case InsertRecord:
+				{
+					Subtitle data;
+
+					stream >> data.text >> data.begin >> data.end >> data.position;
+
+					if (stream.status() != QDataStream::Ok || subtitle < 0 || subtitle > target->count() || (type == SetRecord && subtitle == target->count()))
+					{
+						break;
+					}
+
+					if (type == SetRecord)
+					{
+						target->setSubtitle(subtitle, data);
+					}
+					else
+					{
+						target->insert(subtitle, data);
+					}
+
+					applied = true;
+				}
+
+				break;
+			case RemoveRecord:
+				if (subtitle >= 0 && subtitle < target->count())
+				{
+					target->remove(subtitle);
+
+					applied = true;
+				}
+
+				break;
+			case TransformRecord:
+				{
+					double scale = 1;
+					double offset = 0;
+					qint32 last = -1;
+
+					stream >> scale >> offset >> last;
+
+					if (stream.status() != QDataStream::Ok || scale <= 0)
+					{
+						break;
+					}
+
+					if (target)
+					{
+						target->transform(scale, offset, subtitle, last);
+					}
+					else
+					{
+						for (int i = 0; i < tracks->count() && i < names.count(); ++i)
+						{
+							if (validTracks.contains(names.at(i)))
+							{
+								(*tracks)[i].transform(scale, offset);
+							}
+						}
+					}
+
+					applied = true;
+				}
+
+				break;
+			case TimesRecord:
+				{
+					QVector<qint64> begins;
+					QVector<qint64> ends;
+
+					stream >> begins >> ends;
+
+					if (stream.status() != QDataStream::Ok || begins.count() != target->count() || ends.count() != target->count())
+					{
+						break;
+					}
+
+					target->setTimes(begins, ends);
+
+					applied = true;
+				}
+
+				break;
+			case TrackRecord:
+				{
+					SubtitlesTrack data;
+					qint32 size = 0;
+
+					stream >> size;
+
+					for (qint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i)
+					{
+						Subtitle subtitle;
+
+						stream >> subtitle.text >> subtitle.begin >> subtitle.end >> subtitle.position;
+
+						data.append(subtitle);
+					}
+
+					if (stream.status() != QDataStream::Ok)
+					{
+						break;
+					}
+
+					data.setModified(true);
+
+					*target = data;
+
+					applied = true;
+				}
+
+				break;
+			default:
+				break;
+		}
+
+		if (!applied)
+		{
+			break;
+		}
+
+		validSize = file.pos();
+
+		++count;
+	}
+
+	if (validSize < file.size())
+	{
+		file.resize(validSize);
+	}
+
+	return count;
+}
+
+QString SubtitlesJournal::journalPath(const QString &path)
+{
+	return (path + ".journal");
+}
+
+QString SubtitlesJournal::trackName(const QString &fileName)
+{
+	return QFileInfo(fileName).fileName();
+}
+
+qint64 SubtitlesJournal::modificationTime(const QString &fileName)
+{
+	const QFileInfo fileInfo(fileName);
+
+	return (fileInfo.exists() ? fileInfo.lastModified().toMSecsSinceEpoch() : 0);
+}
@@ -0,0 +1,90 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESJOURNAL_H
+#define SUBTITLESJOURNAL_H
+
+#include "SubtitlesTrack.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+
+class QTimer;
+
+class SubtitlesJournal : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum RecordType
+	{
+		SetRecord = 0,
+		InsertRecord,
+		RemoveRecord,
+		TransformRecord,
+		TimesRecord,
+		TrackRecord
+	};
+
+	enum
+	{
+		FlushInterval = 1000,
+		FlushSize = 65536
+	};
+
+	explicit SubtitlesJournal(QObject *parent = NULL);
+	~SubtitlesJournal();
+
+	void setPath(const QString &path);
+	void setTracks(const QStringList &fileNames);
+	void recordSet(int track, int subtitle, const Subtitle &data);
+	void recordInsert(int track, int subtitle, const Subtitle &data);
+	void recordRemove(int track, int subtitle);
+	void recordTransform(double scale, double offset, int track = -1, int first = 0, int last = -1);
+	void recordTimes(int track, const QVector<qint64> &begins, const QVector<qint64> &ends);
+	void recordTrack(int track, const SubtitlesTrack &data);
+	QString path() const;
+	static int recordCount(const QString &path, const QStringList &fileNames);
+	static int replay(const QString &path, QList<SubtitlesTrack> *tracks, const QStringList &fileNames);
+	static QString journalPath(const QString &path);
+
+public slots:
+	void flush();
+	void clear();
+
+protected:
+	void append(RecordType type, int track, int subtitle, const QByteArray &payload = QByteArray());
+	static bool readHeader(QFile *file, const QString &path, QSet<QString> *tracks);
+	static bool readRecord(QFile *file, QByteArray *record);
+	static QString trackName(const QString &fileName);
+	static qint64 modificationTime(const QString &fileName);
+
+private:
+	QFile m_file;
+	QByteArray m_buffer;
+	QTimer *m_flushTimer;
+	QString m_path;
+	QStringList m_tracks;
+};
+
+#endif
@@ -0,0 +1,304 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesLinter.h"
+
+#include <QtCore/QCoreApplication>
+
+#include <algorithm>
+
+struct OrderLessThan
+{
+	explicit OrderLessThan(const qint64 *begins) : m_begins(begins)
+	{
+	}
+
+	bool operator()(int first, int second) const
+	{
+		return (m_begins[first] < m_begins[second] || (m_begins[first] == m_begins[second] && first < second));
+	}
+
+	const qint64 *m_begins;
+};
+
+SubtitlesLinter::SubtitlesLinter() : m_maximumLength(0),
+	m_problemCount(0)
+{
+}
+
+void SubtitlesLinter::clear()
+{
+	m_begins.clear();
+	m_ends.clear();
+	m_order.clear();
+	m_problems.clear();
+	m_maximumLength = 0;
+	m_problemCount = 0;
+}
+
+void SubtitlesLinter::scan(const SubtitlesTrack &track)
+{
+	const int size = track.count();
+
+	m_begins = track.beginTimes();
+	m_ends = track.endTimes();
+	m_order.resize(size);
+	m_problems.fill(NoProblem, size);
+	m_maximumLength = 0;
+	m_problemCount = 0;
+
+	for (int i = 0; i < size; ++i)
+	{
+		m_order[i] = i;
+		m_maximumLength = qMax(m_maximumLength, (m_ends.at(i) - m_begins.at(i)));
+	}
+
+	std::sort(m_order.begin(), m_order.end(), OrderLessThan(m_begins.constData()));
+
+	QVector<int> timed;
+	timed.reserve(size);
+
+	for (int i = 0; i < size; ++i)
+	{
+		if (m_ends.at(m_order.at(i)) > m_begins.at(m_order.at(i)))
+		{
+			timed.append(m_order.at(i));
+		}
+	}
+
+	qint64 maximumEnd = 0;
+
+	for (int i = 0; i < timed.count(); ++i)
+	{
+		const int subtitle = timed.at(i);
+		const bool overlapsPrevious = (i > 0 && maximumEnd > m_begins.at(subtitle));
+		const bool overlapsNext = ((i + 1) < timed.count() && m_begins.at(timed.at(i + 1)) < m_ends.at(subtitle));
+
+		if (overlapsPrevious || overlapsNext)
+		{
+			m_problems[subtitle] = OverlapProblem;
+		}
+
+		maximumEnd = qMax(maximumEnd, m_ends.at(subtitle));
+	}
+
+	for (int i = 0; i < size; ++i)
+	{
+		m_problems[i] = (m_problems.at(i) | checkSubtitle(track.subtitle(i)));
+
+		if (m_problems.at(i) != NoProblem)
+		{
+			++m_problemCount;
+		}
+	}
+}
+
+QVector<int> SubtitlesLinter::update(const SubtitlesTrack &track, int subtitle)
+{
+	QVector<int> changed;
+
+	if (track.count() != m_begins.count())
+	{
+		scan(track);
+
+		for (int i = 0; i < track.count(); ++i)
+		{
+			changed.append(i);
+		}
+
+		return changed;
+	}
+
+	const int previousProblems = problems(subtitle);
+	QVector<int> affected;
+
+	if (track.begin(subtitle) != m_begins.at(subtitle) || track.end(subtitle) != m_ends.at(subtitle))
+	{
+		affected = neighbours(subtitle);
+
+		m_order.remove(orderPosition(subtitle));
+
+		m_begins[subtitle] = track.begin(subtitle);
+		m_ends[subtitle] = track.end(subtitle);
+		m_maximumLength = qMax(m_maximumLength, (track.end(subtitle) - track.begin(subtitle)));
+
+		m_order.insert(orderPosition(subtitle), subtitle);
+
+		affected += neighbours(subtitle);
+
+		for (int i = 0; i < affected.count(); ++i)
+		{
+			const int neighbour = affected.at(i);
+			const int neighbourProblems = problems(neighbour);
+
+			setProblems(neighbour, ((neighbourProblems & ~OverlapProblem) | (neighbours(neighbour).isEmpty() ? NoProblem : OverlapProblem)));
+
+			if (problems(neighbour) != neighbourProblems)
+			{
+				changed.append(neighbour);
+			}
+		}
+
+		setProblems(subtitle, ((neighbours(subtitle).isEmpty() ? NoProblem : OverlapProblem) | checkSubtitle(track.subtitle(subtitle))));
+	}
+	else
+	{
+		setProblems(subtitle, ((previousProblems & OverlapProblem) | checkSubtitle(track.subtitle(subtitle))));
+	}
+
+	if (problems(subtitle) != previousProblems)
+	{
+		changed.append(subtitle);
+	}
+
+	return changed;
+}
+
+QVector<int> SubtitlesLinter::neighbours(int subtitle) const
+{
+	QVector<int> result;
+	const qint64 begin = m_begins.at(subtitle);
+	const qint64 end = m_ends.at(subtitle);
+
+	if (end <= begin)
+	{
+		return result;
+	}
+
+	const int position = orderPosition(subtitle);
+
+	for (int i = (position - 1); i >= 0 && m_begins.at(m_order.at(i)) > (begin - m_maximumLength); --i)
+	{
+		const int other = m_order.at(i);
+
+		if (m_ends.at(other) > begin && m_ends.at(other) > m_begins.at(other))
+		{
+			result.append(other);
+		}
+	}
+
+	for (int i = (position + 1); i < m_order.count() && m_begins.at(m_order.at(i)) < end; ++i)
+	{
+		const int other = m_order.at(i);
+
+		if (m_ends.at(other) > m_begins.at(other))
+		{
+			result.append(other);
+		}
+	}
+
+	return result;
+}
+
+int SubtitlesLinter::orderPosition(int subtitle) const
+{
+	return (std::lower_bound(m_order.constBegin(), m_order.constEnd(), subtitle, OrderLessThan(m_begins.constData())) - m_order.constBegin());
+}
+
+void SubtitlesLinter::setProblems(int subtitle, int problems)
+{
+	if (m_problems.at(subtitle) != NoProblem)
+	{
+		--m_problemCount;
+	}
+
+	m_problems[subtitle] = problems;
+
+	if (problems != NoProblem)
+	{
+		++m_problemCount;
+	}
+}
+
+int SubtitlesLinter::problems(int subtitle) const
+{
+	return m_problems.value(subtitle, NoProblem);
+}
+
+int SubtitlesLinter::problemCount() const
+{
+	return m_problemCount;
+}
+
+int SubtitlesLinter::count() const
+{
+	return m_problems.count();
+}
+
+int SubtitlesLinter::checkSubtitle(const Subtitle &subtitle)
+{
+	const qint64 length = (subtitle.end - subtitle.begin);
+	const QStringList lines = subtitle.text.split('\n');
+	int characters = 0;
+	int width = 0;
+	int problems = NoProblem;
+
+	for (int i = 0; i < lines.count(); ++i)
+	{
+		const int lineCharacters = lines.at(i).trimmed().length();
+
+		characters += lineCharacters;
+		width = qMax(width, (lineCharacters * CharacterWidth));
+	}
+
+	if (length <= 0)
+	{
+		problems |= LengthProblem;
+	}
+	else if ((characters * 1000) > (length * MaximumReadingSpeed))
+	{
+		problems |= ReadingSpeedProblem;
+	}
+
+	if (subtitle.position.x() < 0 || subtitle.position.y() < 0 || (subtitle.position.x() + width) > FrameWidth || (subtitle.position.y() + (lines.count() * LineHeight)) > FrameHeight)
+	{
+		problems |= PositionProblem;
+	}
+
+	return problems;
+}
+
+QStringList SubtitlesLinter::describe(int problems)
+{
+	QStringList descriptions;
+
+	if (problems & OverlapProblem)
+	{
+		descriptions.append(QCoreApplication::translate("SubtitlesLinter", "Overlaps another subtitle"));
+	}
+
+	if (problems & LengthProblem)
+	{
+		descriptions.append(QCoreApplication::translate("SubtitlesLinter", "Length is zero or negative"));
+	}
+
+	if (problems & ReadingSpeedProblem)
+	{
+		descriptions.append(QCoreApplication::translate("SubtitlesLinter", "Reading speed exceeds %1 characters per second").arg(int(MaximumReadingSpeed)));
+	}
+
+	if (problems & PositionProblem)
+	{
+		descriptions.append(QCoreApplication::translate("SubtitlesLinter", "Text extends outside of %1x%2 frame").arg(int(FrameWidth)).arg(int(FrameHeight)));
+	}
+
+	return descriptions;
+}
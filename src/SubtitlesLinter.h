@@ -0,0 +1,75 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESLINTER_H
+#define SUBTITLESLINTER_H
+
+#include "SubtitlesTrack.h"
+
+#include <QtCore/QStringList>
+
+class SubtitlesLinter
+{
+public:
+	enum Problem
+	{
+		NoProblem = 0,
+		OverlapProblem = 1,
+		LengthProblem = 2,
+		ReadingSpeedProblem = 4,
+		PositionProblem = 8
+	};
+
+	enum
+	{
+		FrameWidth = 640,
+		FrameHeight = 480,
+		CharacterWidth = 7,
+		LineHeight = 15,
+		MaximumReadingSpeed = 20
+	};
+
+	SubtitlesLinter();
+
+	void clear();
+	void scan(const SubtitlesTrack &track);
+	QVector<int> update(const SubtitlesTrack &track, int subtitle);
+	int problems(int subtitle) const;
+	int problemCount() const;
+	int count() const;
+	static int checkSubtitle(const Subtitle &subtitle);
+	static QStringList describe(int problems);
+
+protected:
+	QVector<int> neighbours(int subtitle) const;
+	int orderPosition(int subtitle) const;
+	void setProblems(int subtitle, int problems);
+
+private:
+	QVector<qint64> m_begins;
+	QVector<qint64> m_ends;
+	QVector<int> m_order;
+	QVector<quint8> m_problems;
+	qint64 m_maximumLength;
+	int m_problemCount;
+};
+
+#endif
@@ -0,0 +1,212 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesMerge.h"
+
+SubtitlesMerge::SubtitlesMerge(const SubtitlesTrack &base, const SubtitlesTrack &local, const SubtitlesTrack &remote) : m_base(base),
+	m_local(local),
+	m_remote(remote),
+	m_conflicts(0)
+{
+	merge();
+}
+
+void SubtitlesMerge::merge()
+{
+	const QVector<int> localMatches = match(m_base, m_local);
+	const QVector<int> remoteMatches = match(m_base, m_remote);
+	int base = 0;
+	int local = 0;
+	int remote = 0;
+
+	m_track.reserve(qMax(m_local.count(), m_remote.count()));
+
+	for (int i = 0; i <= m_base.count(); ++i)
+	{
+		const bool anchor = (i == m_base.count() || (localMatches.at(i) >= 0 && remoteMatches.at(i) >= 0));
+
+		if (!anchor)
+		{
+			continue;
+		}
+
+		const int localEnd = ((i == m_base.count()) ? m_local.count() : localMatches.at(i));
+		const int remoteEnd = ((i == m_base.count()) ? m_remote.count() : remoteMatches.at(i));
+
+		if (isRangeEqual(m_base, base, i, m_local, local, localEnd) || isRangeEqual(m_local, local, localEnd, m_remote, remote, remoteEnd))
+		{
+			appendRange(m_remote, remote, remoteEnd, false);
+		}
+		else if (isRangeEqual(m_base, base, i, m_remote, remote, remoteEnd))
+		{
+			appendRange(m_local, local, localEnd, true);
+		}
+		else
+		{
+			appendRange(m_local, local, localEnd, true);
+
+			++m_conflicts;
+		}
+
+		if (i < m_base.count())
+		{
+			m_track.append(m_local.subtitle(localEnd));
+
+			if (m_local.isModified(localEnd))
+			{
+				m_track.setModified((m_track.count() - 1), true);
+			}
+		}
+
+		base = (i + 1);
+		local = (localEnd + 1);
+		remote = (remoteEnd + 1);
+	}
+
+	if (!isRangeEqual(m_track, 0, m_track.count(), m_remote, 0, m_remote.count()))
+	{
+		m_track.setModified(true);
+	}
+}
+
+void SubtitlesMerge::appendRange(const SubtitlesTrack &source, int from, int to, bool modified)
+{
+	for (int i = from; i < to; ++i)
+	{
+		m_track.append(source.subtitle(i));
+
+		if (modified)
+		{
+			m_track.setModified((m_track.count() - 1), true);
+		}
+	}
+}
+
+bool SubtitlesMerge::isRangeEqual(const SubtitlesTrack &first, int firstFrom, int firstTo, const SubtitlesTrack &second, int secondFrom, int secondTo) const
+{
+	if ((firstTo - firstFrom) != (secondTo - secondFrom))
+	{
+		return false;
+	}
+
+	for (int i = 0; i < (firstTo - firstFrom); ++i)
+	{
+		if (first.subtitle(firstFrom + i) != second.subtitle(secondFrom + i))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+QVector<int> SubtitlesMerge::match(const SubtitlesTrack &base, const SubtitlesTrack &other)
+{
+	QVector<int> matches(base.count(), -1);
+	int prefix = 0;
+	int suffix = 0;
+
+	while (prefix < base.count() && prefix < other.count() && base.subtitle(prefix) == other.subtitle(prefix))
+	{
+		matches[prefix] = prefix;
+
+		++prefix;
+	}
+
+	while (suffix < (base.count() - prefix) && suffix < (other.count() - prefix) && base.subtitle(base.count() - suffix - 1) == other.subtitle(other.count() - suffix - 1))
+	{
+		matches[base.count() - suffix - 1] = (other.count() - suffix - 1);
+
+		++suffix;
+	}
+
+	const int rows = (base.count() - prefix - suffix);
+	const int columns = (other.count() - prefix - suffix);
+
+	if (rows == 0 || columns == 0 || (qint64(rows + 1) * (columns + 1)) > MaximumMatrixSize)
+	{
+		return matches;
+	}
+
+	QVector<Subtitle> baseSubtitles(rows);
+	QVector<Subtitle> otherSubtitles(columns);
+
+	for (int i = 0; i < rows; ++i)
+	{
+		baseSubtitles[i] = base.subtitle(prefix + i);
+	}
+
+	for (int i = 0; i < columns; ++i)
+	{
+		otherSubtitles[i] = other.subtitle(prefix + i);
+	}
+
+	QVector<int> lengths((rows + 1) * (columns + 1), 0);
+
+	for (int i = (rows - 1); i >= 0; --i)
+	{
+		for (int j = (columns - 1); j >= 0; --j)
+		{
+			if (baseSubtitles.at(i) == otherSubtitles.at(j))
+			{
+				lengths[(i * (columns + 1)) + j] = (lengths.at(((i + 1) * (columns + 1)) + j + 1) + 1);
+			}
+			else
+			{
+				lengths[(i * (columns + 1)) + j] = qMax(lengths.at(((i + 1) * (columns + 1)) + j), lengths.at((i * (columns + 1)) + j + 1));
+			}
+		}
+	}
+
+	int i = 0;
+	int j = 0;
+
+	while (i < rows && j < columns)
+	{
+		if (baseSubtitles.at(i) == otherSubtitles.at(j))
+		{
+			matches[prefix + i] = (prefix + j);
+
+			++i;
+			++j;
+		}
+		else if (lengths.at(((i + 1) * (columns + 1)) + j) >= lengths.at((i * (columns + 1)) + j + 1))
+		{
+			++i;
+		}
+		else
+		{
+			++j;
+		}
+	}
+
+	return matches;
+}
+
+SubtitlesTrack SubtitlesMerge::track() const
+{
+	return m_track;
+}
+
+int SubtitlesMerge::conflicts() const
+{
+	return m_conflicts;
+}
@@ -0,0 +1,54 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESMERGE_H
+#define SUBTITLESMERGE_H
+
+#include "SubtitlesTrack.h"
+
+class SubtitlesMerge
+{
+public:
+	enum
+	{
+		MaximumMatrixSize = 4194304
+	};
+
+	SubtitlesMerge(const SubtitlesTrack &base, const SubtitlesTrack &local, const SubtitlesTrack &remote);
+
+	SubtitlesTrack track() const;
+	int conflicts() const;
+
+protected:
+	void merge();
+	void appendRange(const SubtitlesTrack &source, int from, int to, bool modified);
+	bool isRangeEqual(const SubtitlesTrack &first, int firstFrom, int firstTo, const SubtitlesTrack &second, int secondFrom, int secondTo) const;
+	static QVector<int> match(const SubtitlesTrack &base, const SubtitlesTrack &other);
+
+private:
+	const SubtitlesTrack &m_base;
+	const SubtitlesTrack &m_local;
+	const SubtitlesTrack &m_remote;
+	SubtitlesTrack m_track;
+	int m_conflicts;
+};
+
+#endif
@@ -0,0 +1,423 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesModel.h"
+#include "SubtitlesHistory.h"
+#include "SubtitlesWriter.h"
+
+#include <QtGui/QColor>
+#include <QtGui/QFont>
+
+SubtitlesModel::SubtitlesModel(QList<SubtitlesTrack> *tracks, SubtitlesHistory *history, QObject *parent) : QAbstractTableModel(parent),
+	m_tracks(tracks),
+	m_history(history),
+	m_track(0)
+{
+	connect(m_history, SIGNAL(subtitlesChanged(int,int,int)), this, SLOT(subtitlesChanged(int,int,int)));
+	connect(m_history, SIGNAL(subtitleAboutToBeInserted(int,int)), this, SLOT(subtitleAboutToBeInserted(int,int)));
+	connect(m_history, SIGNAL(subtitleInserted(int,int)), this, SLOT(subtitleInserted(int,int)));
+	connect(m_history, SIGNAL(subtitleAboutToBeRemoved(int,int)), this, SLOT(subtitleAboutToBeRemoved(int,int)));
+	connect(m_history, SIGNAL(subtitleRemoved(int,int)), this, SLOT(subtitleRemoved(int,int)));
+}
+
+void SubtitlesModel::setTrack(int track)
+{
+	beginResetModel();
+
+	m_track = track;
+
+	if (m_track >= 0 && m_track < m_tracks->count())
+	{
+		m_linter.scan(m_tracks->at(m_track));
+	}
+	else
+	{
+		m_linter.clear();
+	}
+
+	endResetModel();
+}
+
+void SubtitlesModel::tracksChanged()
+{
+	setTrack(m_track);
+}
+
+void SubtitlesModel::subtitlesChanged(int track, int first, int last)
+{
+	if (track != m_track || first > last || last >= rowCount())
+	{
+		return;
+	}
+
+	if ((last - first) >= MaximumIncrementalRows)
+	{
+		m_linter.scan(m_tracks->at(m_track));
+
+		emit dataChanged(index(0, 0), index((rowCount() - 1), (ColumnCount - 1)));
+
+		return;
+	}
+
+	int changedFirst = first;
+	int changedLast = last;
+
+	for (int i = first; i <= last; ++i)
+	{
+		const QVector<int> changed = m_linter.update(m_tracks->at(m_track), i);
+
+		for (int j = 0; j < changed.count(); ++j)
+		{
+			changedFirst = qMin(changedFirst, changed.at(j));
+			changedLast = qMax(changedLast, changed.at(j));
+		}
+	}
+
+	emit dataChanged(index(changedFirst, 0), index(changedLast, (ColumnCount - 1)));
+}
+
+void SubtitlesModel::subtitleAboutToBeInserted(int track, int subtitle)
+{
+	if (track == m_track)
+	{
+		beginInsertRows(QModelIndex(), subtitle, subtitle);
+	}
+}
+
+void SubtitlesModel::subtitleInserted(int track, int subtitle)
+{
+	if (track != m_track)
+	{
+		return;
+	}
+
+	const SubtitlesLinter previous = m_linter;
+
+	m_linter.scan(m_tracks->at(m_track));
+
+	endInsertRows();
+
+	updateProblems(previous, subtitle, 1);
+}
+
+void SubtitlesModel::subtitleAboutToBeRemoved(int track, int subtitle)
+{
+	if (track == m_track)
+	{
+		beginRemoveRows(QModelIndex(), subtitle, subtitle);
+	}
+}
+
+void SubtitlesModel::subtitleRemoved(int track, int subtitle)
+{
+	if (track != m_track)
+	{
+		return;
+	}
+
+	const SubtitlesLinter previous = m_linter;
+
+	m_linter.scan(m_tracks->at(m_track));
+
+	endRemoveRows();
+
+	updateProblems(previous, subtitle, -1);
+}
+
+bool SubtitlesModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+	if (role != Qt::EditRole || !index.isValid() || index.row() >= rowCount())
+	{
+		return false;
+	}
+
+	const Subtitle subtitle = m_tracks->at(m_track).subtitle(index.row());
+	const Subtitle data = updatedSubtitle(subtitle, index.column(), value);
+
+	if (data != subtitle)
+	{
+		m_history->edit(m_track, index.row(), data);
+		m_history->seal();
+	}
+
+	return true;
+}
+
+bool SubtitlesModel::setColumnData(const QVector<int> &rows, int column, const QVariant &value)
+{
+	QVector<int> changedRows;
+	QList<Subtitle> data;
+
+	for (int i = 0; i < rows.count(); ++i)
+	{
+		if (rows.at(i) < 0 || rows.at(i) >= rowCount())
+		{
+			return false;
+		}
+
+		const Subtitle subtitle = m_tracks->at(m_track).subtitle(rows.at(i));
+		const Subtitle updated = updatedSubtitle(subtitle, column, value);
+
+		if (updated != subtitle)
+		{
+			changedRows.append(rows.at(i));
+			data.append(updated);
+		}
+	}
+
+	if (!changedRows.isEmpty())
+	{
+		m_history->edit(m_track, changedRows, data);
+	}
+
+	return true;
+}
+
+bool SubtitlesModel::shiftTimes(const QVector<int> &rows, qint64 offset)
+{
+	QVector<int> changedRows;
+	QList<Subtitle> data;
+
+	for (int i = 0; i < rows.count(); ++i)
+	{
+		if (rows.at(i) < 0 || rows.at(i) >= rowCount())
+		{
+			return false;
+		}
+
+		Subtitle subtitle = m_tracks->at(m_track).subtitle(rows.at(i));
+		subtitle.begin = qMax(qint64(0), (subtitle.begin + offset));
+		subtitle.end = qMax(subtitle.begin, (subtitle.end + offset));
+
+		changedRows.append(rows.at(i));
+		data.append(subtitle);
+	}
+
+	if (!changedRows.isEmpty() && offset != 0)
+	{
+		m_history->edit(m_track, changedRows, data);
+	}
+
+	return true;
+}
+
+Subtitle SubtitlesModel::updatedSubtitle(const Subtitle &subtitle, int column, const QVariant &value) const
+{
+	Subtitle data = subtitle;
+
+	switch (column)
+	{
+		case BeginColumn:
+			data.begin = qMax(qint64(0), value.toLongLong());
+			data.end = (data.begin + (subtitle.end - subtitle.begin));
+
+			break;
+		case EndColumn:
+			data.end = qMax(data.begin, value.toLongLong());
+
+			break;
+		case TextColumn:
+			data.text = value.toString();
+
+			break;
+		case XPositionColumn:
+			data.position.setX(value.toInt());
+
+			break;
+		case YPositionColumn:
+			data.position.setY(value.toInt());
+
+			break;
+		default:
+			break;
+	}
+
+	return data;
+}
+
+void SubtitlesModel::updateProblems(const SubtitlesLinter &previous, int subtitle, int delta)
+{
+	int first = -1;
+	int last = -1;
+
+	for (int i = 0; i < rowCount(); ++i)
+	{
+		if (delta > 0 && i == subtitle)
+		{
+			continue;
+		}
+
+		if (m_linter.problems(i) != previous.problems((i < subtitle) ? i : (i - delta)))
+		{
+			if (first < 0)
+			{
+				first = i;
+			}
+
+			last = i;
+		}
+	}
+
+	if (first >= 0)
+	{
+		emit dataChanged(index(first, 0), index(last, (ColumnCount - 1)));
+	}
+}
+
+QVariant SubtitlesModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.row() >= rowCount())
+	{
+		return QVariant();
+	}
+
+	const SubtitlesTrack &track = m_tracks->at(m_track);
+	const int row = index.row();
+
+	if (role == Qt::FontRole)
+	{
+		if (track.isModified(row))
+		{
+			QFont font;
+			font.setBold(true);
+
+			return font;
+		}
+
+		return QVariant();
+	}
+
+	if (role == Qt::BackgroundRole)
+	{
+		return ((m_linter.problems(row) == SubtitlesLinter::NoProblem) ? QVariant() : QVariant(QColor(255, 0, 0, 48)));
+	}
+
+	if (role == Qt::ToolTipRole)
+	{
+		QStringList lines = SubtitlesLinter::describe(m_linter.problems(row));
+
+		if (index.column() == TextColumn)
+		{
+			lines.prepend(track.text(row));
+		}
+
+		return (lines.isEmpty() ? QVariant() : QVariant(lines.join("\n")));
+	}
+
+	if (role != Qt::DisplayRole && role != Qt::EditRole && role != SortRole)
+	{
+		return QVariant();
+	}
+
+	switch (index.column())
+	{
+		case BeginColumn:
+		case EndColumn:
+			{
+				const qint64 time = ((index.column() == BeginColumn) ? track.begin(row) : track.end(row));
+
+				if (role != Qt::DisplayRole)
+				{
+					return time;
+				}
+
+				char buffer[32];
+
+				return QString::fromLatin1(buffer, SubtitlesWriter::formatTime(time, buffer, true));
+			}
+		case TextColumn:
+			return ((role == Qt::DisplayRole) ? QString(track.text(row)).replace('\n', ' ') : track.text(row));
+		case XPositionColumn:
+			return track.position(row).x();
+		case YPositionColumn:
+			return track.position(row).y();
+		default:
+			break;
+	}
+
+	return QVariant();
+}
+
+QVariant SubtitlesModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+	{
+		return QAbstractTableModel::headerData(section, orientation, role);
+	}
+
+	switch (section)
+	{
+		case BeginColumn:
+			return tr("Begin");
+		case EndColumn:
+			return tr("End");
+		case TextColumn:
+			return tr("Text");
+		case XPositionColumn:
+			return tr("X");
+		case YPositionColumn:
+			return tr("Y");
+		default:
+			break;
+	}
+
+	return QVariant();
+}
+
+Qt::ItemFlags SubtitlesModel::flags(const QModelIndex &index) const
+{
+	if (!index.isValid())
+	{
+		return Qt::NoItemFlags;
+	}
+
+	return (Qt::ItemIsSelectable | Qt::ItemIsEditable | Qt::ItemIsEnabled);
+}
+
+int SubtitlesModel::track() const
+{
+	return m_track;
+}
+
+int SubtitlesModel::problems(int row) const
+{
+	return m_linter.problems(row);
+}
+
+int SubtitlesModel::problemCount() const
+{
+	return m_linter.problemCount();
+}
+
+int SubtitlesModel::rowCount(const QModelIndex &parent) const
+{
+	if (parent.isValid() || m_track < 0 || m_track >= m_tracks->count())
+	{
+		return 0;
+	}
+
+	return m_tracks->at(m_track).count();
+}
+
+int SubtitlesModel::columnCount(const QModelIndex &parent) const
+{
+	return (parent.isValid() ? 0 : ColumnCount);
+}
@@ -0,0 +1,89 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESMODEL_H
+#define SUBTITLESMODEL_H
+
+#include "SubtitlesLinter.h"
+#include "SubtitlesTrack.h"
+
+#include <QtCore/QAbstractTableModel>
+
+class SubtitlesHistory;
+
+class SubtitlesModel : public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+	enum Column
+	{
+		BeginColumn = 0,
+		EndColumn,
+		TextColumn,
+		XPositionColumn,
+		YPositionColumn,
+		ColumnCount
+	};
+
+	enum
+	{
+		SortRole = Qt::UserRole,
+		MaximumIncrementalRows = 64
+	};
+
+	SubtitlesModel(QList<SubtitlesTrack> *tracks, SubtitlesHistory *history, QObject *parent = NULL);
+
+	void setTrack(int track);
+	bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole);
+	bool setColumnData(const QVector<int> &rows, int column, const QVariant &value);
+	bool shiftTimes(const QVector<int> &rows, qint64 offset);
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+	Qt::ItemFlags flags(const QModelIndex &index) const;
+	int track() const;
+	int problems(int row) const;
+	int problemCount() const;
+	int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const;
+
+public slots:
+	void tracksChanged();
+
+protected:
+	Subtitle updatedSubtitle(const Subtitle &subtitle, int column, const QVariant &value) const;
+	void updateProblems(const SubtitlesLinter &previous, int subtitle, int delta);
+
+protected slots:
+	void subtitlesChanged(int track, int first, int last);
+	void subtitleAboutToBeInserted(int track, int subtitle);
+	void subtitleInserted(int track, int subtitle);
+	void subtitleAboutToBeRemoved(int track, int subtitle);
+	void subtitleRemoved(int track, int subtitle);
+
+private:
+	QList<SubtitlesTrack> *m_tracks;
+	SubtitlesHistory *m_history;
+	SubtitlesLinter m_linter;
+	int m_track;
+};
+
+#endif
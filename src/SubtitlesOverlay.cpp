@@ -0,0 +1,229 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesOverlay.h"
+
+#include <QtCore/QtMath>
+#include <QtCore/QVector>
+#include <QtGui/QAbstractTextDocumentLayout>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QPainter>
+#include <QtGui/QTextDocument>
+
+static void blurLine(QRgb *pixels, int stride, int length, int radius, QRgb *buffer)
+{
+	const int window = ((radius * 2) + 1);
+	int alpha = 0;
+	int red = 0;
+	int green = 0;
+	int blue = 0;
+
+	for (int i = 0; i < length; ++i)
+	{
+		buffer[i] = pixels[i * stride];
+	}
+
+	for (int i = 0; i <= radius && i < length; ++i)
+	{
+		alpha += qAlpha(buffer[i]);
+		red += qRed(buffer[i]);
+		green += qGreen(buffer[i]);
+		blue += qBlue(buffer[i]);
+	}
+
+	for (int i = 0; i < length; ++i)
+	{
+		pixels[i * stride] = qRgba((red / window), (green / window), (blue / window), (alpha / window));
+
+		const int next = (i + radius + 1);
+		const int previous = (i - radius);
+
+		if (next < length)
+		{
+			alpha += qAlpha(buffer[next]);
+			red += qRed(buffer[next]);
+			green += qGreen(buffer[next]);
+			blue += qBlue(buffer[next]);
+		}
+
+		if (previous >= 0)
+		{
+			alpha -= qAlpha(buffer[previous]);
+			red -= qRed(buffer[previous]);
+			green -= qGreen(buffer[previous]);
+			blue -= qBlue(buffer[previous]);
+		}
+	}
+}
+
+SubtitlesOverlay::SubtitlesOverlay(Qt::Alignment alignment, QGraphicsItem *parent) : QGraphicsItem(parent),
+	m_alignment(alignment)
+{
+}
+
+void SubtitlesOverlay::setHtml(const QString &html)
+{
+	if (html == m_html)
+	{
+		return;
+	}
+
+	m_html = html;
+
+	relayout();
+}
+
+void SubtitlesOverlay::setArea(const QRectF &area)
+{
+	const bool resized = (area.size() != m_area.size());
+
+	m_area = area;
+
+	if (resized)
+	{
+		relayout();
+	}
+	else
+	{
+		updatePosition();
+	}
+}
+
+void SubtitlesOverlay::relayout()
+{
+	prepareGeometryChange();
+
+	if (m_html.isEmpty() || m_area.width() <= 0 || m_area.height() <= 0)
+	{
+		m_pixmap = QPixmap();
+
+		updatePosition();
+		update();
+
+		return;
+	}
+
+	const qreal ratio = qApp->devicePixelRatio();
+	const qreal scale = qMin((m_area.width() / GameWidth), (m_area.height() / GameHeight));
+	const int margin = qCeil(ShadowRadius * ratio);
+	QFont font("DejaVu Sans");
+	font.setPixelSize(qMax(1, qRound(GameFontSize * scale)));
+
+	QTextDocument document;
+	document.setDefaultFont(font);
+	document.setHtml(m_html);
+	document.setTextWidth(GameWidth * scale);
+
+	QImage image((QSize(qCeil(document.size().width() * ratio), qCeil(document.size().height() * ratio)) + QSize((margin * 2), (margin * 2))), QImage::Format_ARGB32_Premultiplied);
+	image.fill(Qt::transparent);
+
+	QAbstractTextDocumentLayout::PaintContext context;
+	context.palette.setColor(QPalette::Text, QColor(Qt::black));
+
+	QPainter painter(&image);
+	painter.translate(margin, margin);
+	painter.scale(ratio, ratio);
+
+	document.documentLayout()->draw(&painter, context);
+
+	painter.end();
+
+	blur(&image, margin);
+
+	context.palette.setColor(QPalette::Text, QColor(230, 230, 230));
+
+	painter.begin(&image);
+	painter.translate(margin, margin);
+	painter.scale(ratio, ratio);
+
+	document.documentLayout()->draw(&painter, context);
+
+	painter.end();
+
+	m_pixmap = QPixmap::fromImage(image);
+	m_pixmap.setDevicePixelRatio(ratio);
+
+	updatePosition();
+	update();
+}
+
+void SubtitlesOverlay::updatePosition()
+{
+	const qreal margin = (m_pixmap.isNull() ? 0 : (qCeil(ShadowRadius * m_pixmap.devicePixelRatio()) / m_pixmap.devicePixelRatio()));
+	const qreal height = boundingRect().height();
+
+	if (m_alignment & Qt::AlignBottom)
+	{
+		setPos((m_area.left() - margin), (m_area.bottom() - height + margin));
+	}
+	else
+	{
+		setPos((m_area.left() - margin), (m_area.top() - margin));
+	}
+}
+
+void SubtitlesOverlay::blur(QImage *image, int radius)
+{
+	if (radius < 1 || image->isNull())
+	{
+		return;
+	}
+
+	const int width = image->width();
+	const int height = image->height();
+	const int stride = (image->bytesPerLine() / sizeof(QRgb));
+	QRgb *pixels = reinterpret_cast<QRgb*>(image->bits());
+	QVector<QRgb> buffer(qMax(width, height));
+
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		for (int y = 0; y < height; ++y)
+		{
+			blurLine((pixels + (y * stride)), 1, width, radius, buffer.data());
+		}
+
+		for (int x = 0; x < width; ++x)
+		{
+			blurLine((pixels + x), stride, height, radius, buffer.data());
+		}
+	}
+}
+
+void SubtitlesOverlay::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+	Q_UNUSED(option)
+	Q_UNUSED(widget)
+
+	if (!m_pixmap.isNull())
+	{
+		painter->drawPixmap(QPointF(0, 0), m_pixmap);
+	}
+}
+
+QRectF SubtitlesOverlay::boundingRect() const
+{
+	if (m_pixmap.isNull())
+	{
+		return QRectF();
+	}
+
+	return QRectF(QPointF(0, 0), (QSizeF(m_pixmap.size()) / m_pixmap.devicePixelRatio()));
+}
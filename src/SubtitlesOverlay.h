@@ -0,0 +1,58 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESOVERLAY_H
+#define SUBTITLESOVERLAY_H
+
+#include <QtGui/QPixmap>
+#include <QtWidgets/QGraphicsItem>
+
+class SubtitlesOverlay : public QGraphicsItem
+{
+public:
+	enum
+	{
+		GameWidth = 640,
+		GameHeight = 480,
+		GameFontSize = 12,
+		ShadowRadius = 2
+	};
+
+	explicit SubtitlesOverlay(Qt::Alignment alignment, QGraphicsItem *parent = NULL);
+
+	void setHtml(const QString &html);
+	void setArea(const QRectF &area);
+	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = NULL);
+	QRectF boundingRect() const;
+
+protected:
+	void relayout();
+	void updatePosition();
+	static void blur(QImage *image, int radius);
+
+private:
+	QPixmap m_pixmap;
+	QString m_html;
+	QRectF m_area;
+	Qt::Alignment m_alignment;
+};
+
+#endif
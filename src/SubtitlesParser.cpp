@@ -0,0 +1,306 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesParser.h"
+#include "SubtitlesTrace.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+
+#include <cstring>
+
+static inline bool isSpace(char character)
+{
+	return (character == ' ' || character == '\t' || character == '\r' || character == '\v' || character == '\f');
+}
+
+static inline bool isDigit(char character)
+{
+	return (character >= '0' && character <= '9');
+}
+
+SubtitlesParser::SubtitlesParser()
+{
+}
+
+bool SubtitlesParser::parseFile(const QString &fileName)
+{
+	QFile file(fileName);
+
+	m_track.clear();
+	m_errors.clear();
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	if (file.size() == 0)
+	{
+		return true;
+	}
+
+	const uchar *data = file.map(0, file.size());
+
+	if (data)
+	{
+		parse(reinterpret_cast<const char*>(data), file.size());
+
+		file.unmap(const_cast<uchar*>(data));
+	}
+	else
+	{
+		const QByteArray buffer = file.readAll();
+
+		parse(buffer.constData(), buffer.size());
+	}
+
+	return true;
+}
+
+bool SubtitlesParser::parse(const char *data, qint64 size)
+{
+	SUBTITLES_TRACE("SubtitlesParser::parse");
+
+	const char *position = data;
+	const char *end = (data + size);
+	int line = 1;
+
+	m_track.clear();
+	m_errors.clear();
+
+	if (size >= 3 && static_cast<uchar>(data[0]) == 0xEF && static_cast<uchar>(data[1]) == 0xBB && static_cast<uchar>(data[2]) == 0xBF)
+	{
+		position += 3;
+	}
+
+	while (position < end)
+	{
+		const char *lineEnd = static_cast<const char*>(memchr(position, '\n', (end - position)));
+
+		if (!lineEnd)
+		{
+			lineEnd = end;
+		}
+
+		parseLine(position, lineEnd, line);
+
+		position = (lineEnd + 1);
+
+		++line;
+	}
+
+	return m_errors.isEmpty();
+}
+
+void SubtitlesParser::parseLine(const char *begin, const char *end, int line)
+{
+	const char *lineBegin = begin;
+
+	while (begin < end && isSpace(*begin))
+	{
+		++begin;
+	}
+
+	while (end > begin && isSpace(*(end - 1)))
+	{
+		--end;
+	}
+
+	if (begin == end || ((end - begin) >= 2 && begin[0] == '/' && begin[1] == '/'))
+	{
+		return;
+	}
+
+	const char *position = begin;
+	int coordinates[2] = {0, 0};
+	qint64 times[2] = {0, 0};
+
+	for (int i = 0; i < 4; ++i)
+	{
+		const char *fieldBegin = position;
+
+		if (i < 2)
+		{
+			while (position < end && isDigit(*position))
+			{
+				coordinates[i] = ((coordinates[i] * 10) + (*position - '0'));
+
+				++position;
+			}
+
+			if (position == fieldBegin)
+			{
+				addError(line, (position - lineBegin + 1), QCoreApplication::translate("SubtitlesParser", "Expected %1 coordinate").arg(i ? "Y" : "X"));
+
+				return;
+			}
+		}
+		else
+		{
+			while (position < end && (isDigit(*position) || *position == '.'))
+			{
+				++position;
+			}
+
+			if (!parseTime(fieldBegin, position, &times[i - 2]))
+			{
+				addError(line, (fieldBegin - lineBegin + 1), QCoreApplication::translate("SubtitlesParser", "Invalid %1 time").arg((i == 2) ? QCoreApplication::translate("SubtitlesParser", "begin") : QCoreApplication::translate("SubtitlesParser", "end")));
+
+				return;
+			}
+		}
+
+		if (position == end || !isSpace(*position))
+		{
+			addError(line, (position - lineBegin + 1), QCoreApplication::translate("SubtitlesParser", "Expected whitespace"));
+
+			return;
+		}
+
+		while (position < end && isSpace(*position))
+		{
+			++position;
+		}
+	}
+
+	if (position < end && *position == '_')
+	{
+		++position;
+	}
+
+	if (position < end && *position == '(')
+	{
+		++position;
+	}
+
+	if (position == end || *position != '"')
+	{
+		addError(line, (position - lineBegin + 1), QCoreApplication::translate("SubtitlesParser", "Expected opening quotation mark"));
+
+		return;
+	}
+
+	++position;
+
+	const char *textEnd = end;
+
+	if (*(textEnd - 1) == ')')
+	{
+		--textEnd;
+	}
+
+	if (textEnd <= position || *(textEnd - 1) != '"')
+	{
+		addError(line, (end - lineBegin + 1), QCoreApplication::translate("SubtitlesParser", "Expected closing quotation mark"));
+
+		return;
+	}
+
+	--textEnd;
+
+	if (textEnd == position)
+	{
+		addError(line, (position - lineBegin + 1), QCoreApplication::translate("SubtitlesParser", "Empty subtitle text"));
+
+		return;
+	}
+
+	Subtitle subtitle;
+	subtitle.text = QString::fromUtf8(position, (textEnd - position));
+	subtitle.begin = times[0];
+	subtitle.end = times[1];
+	subtitle.position = QPoint(coordinates[0], coordinates[1]);
+
+	m_track.append(subtitle);
+}
+
+void SubtitlesParser::addError(int line, int column, const QString &message)
+{
+	SubtitlesParserError error;
+	error.line = line;
+	error.column = column;
+	error.message = message;
+
+	m_errors.append(error);
+}
+
+SubtitlesTrack SubtitlesParser::track() const
+{
+	return m_track;
+}
+
+QList<SubtitlesParserError> SubtitlesParser::errors() const
+{
+	return m_errors;
+}
+
+QString SubtitlesParser::errorString() const
+{
+	QStringList messages;
+
+	for (int i = 0; i < m_errors.count(); ++i)
+	{
+		messages.append(QCoreApplication::translate("SubtitlesParser", "Line %1, column %2: %3").arg(m_errors.at(i).line).arg(m_errors.at(i).column).arg(m_errors.at(i).message));
+	}
+
+	return messages.join("\n");
+}
+
+bool SubtitlesParser::parseTime(const char *begin, const char *end, qint64 *time)
+{
+	qint64 seconds = 0;
+	qint64 milliseconds = 0;
+	int scale = 100;
+	bool hasDigits = false;
+
+	while (begin < end && isDigit(*begin))
+	{
+		seconds = ((seconds * 10) + (*begin - '0'));
+		hasDigits = true;
+
+		++begin;
+	}
+
+	if (begin < end && *begin == '.')
+	{
+		++begin;
+
+		while (begin < end && isDigit(*begin))
+		{
+			milliseconds += ((*begin - '0') * scale);
+			scale /= 10;
+			hasDigits = true;
+
+			++begin;
+		}
+	}
+
+	if (!hasDigits || begin != end)
+	{
+		return false;
+	}
+
+	*time = ((seconds * 1000) + milliseconds);
+
+	return true;
+}
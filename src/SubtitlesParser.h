@@ -0,0 +1,62 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESPARSER_H
+#define SUBTITLESPARSER_H
+
+#include "SubtitlesTrack.h"
+
+#include <QtCore/QList>
+
+struct SubtitlesParserError
+{
+	int line;
+	int column;
+	QString message;
+};
+
+class SubtitlesParser
+{
+public:
+	enum
+	{
+		ThroughputTarget = 100
+	};
+
+	SubtitlesParser();
+
+	bool parseFile(const QString &fileName);
+	bool parse(const char *data, qint64 size);
+	SubtitlesTrack track() const;
+	QList<SubtitlesParserError> errors() const;
+	QString errorString() const;
+	static bool parseTime(const char *begin, const char *end, qint64 *time);
+
+protected:
+	void parseLine(const char *begin, const char *end, int line);
+	void addError(int line, int column, const QString &message);
+
+private:
+	SubtitlesTrack m_track;
+	QList<SubtitlesParserError> m_errors;
+};
+
+#endif
@@ -0,0 +1,116 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesRetimer.h"
+#include "Subtitle.h"
+
+SubtitlesRetimer::SubtitlesRetimer(double scale, double offset) : m_scale(scale),
+	m_offset(offset)
+{
+}
+
+void SubtitlesRetimer::apply(qint64 *times, int count) const
+{
+	apply(times, times, count);
+}
+
+void SubtitlesRetimer::apply(const qint64 *input, qint64 *output, int count) const
+{
+	const double scale = m_scale;
+	const double offset = (m_offset + 0.5);
+
+	// Same result as transformTime(), written without branches so that the loop vectorizes
+	for (int i = 0; i < count; ++i)
+	{
+		output[i] = qint64(qMax(((input[i] * scale) + offset), 0.0));
+	}
+}
+
+void SubtitlesRetimer::apply(QVector<qint64> *begins, QVector<qint64> *ends, int first, int last) const
+{
+	first = qMax(0, first);
+	last = qMin(last, (qMin(begins->count(), ends->count()) - 1));
+
+	if (first > last)
+	{
+		return;
+	}
+
+	apply((begins->data() + first), ((last - first) + 1));
+	apply((ends->data() + first), ((last - first) + 1));
+}
+
+qint64 SubtitlesRetimer::apply(qint64 time) const
+{
+	return transformTime(time, m_scale, m_offset);
+}
+
+double SubtitlesRetimer::scale() const
+{
+	return m_scale;
+}
+
+double SubtitlesRetimer::offset() const
+{
+	return m_offset;
+}
+
+bool SubtitlesRetimer::isIdentity() const
+{
+	return (m_scale == 1 && m_offset == 0);
+}
+
+bool SubtitlesRetimer::isValid() const
+{
+	return (m_scale > 0);
+}
+
+SubtitlesRetimer SubtitlesRetimer::shift(qint64 offset)
+{
+	return SubtitlesRetimer(1, offset);
+}
+
+SubtitlesRetimer SubtitlesRetimer::rescale(double scale)
+{
+	return SubtitlesRetimer(scale, 0);
+}
+
+SubtitlesRetimer SubtitlesRetimer::convertFrameRate(double sourceRate, double targetRate)
+{
+	if (sourceRate <= 0 || targetRate <= 0)
+	{
+		return SubtitlesRetimer(0, 0);
+	}
+
+	return SubtitlesRetimer((sourceRate / targetRate), 0);
+}
+
+SubtitlesRetimer SubtitlesRetimer::fit(qint64 firstSource, qint64 firstTarget, qint64 secondSource, qint64 secondTarget)
+{
+	if (firstSource == secondSource)
+	{
+		return ((firstTarget == secondTarget) ? shift(firstTarget - firstSource) : SubtitlesRetimer(0, 0));
+	}
+
+	const double scale = (double(secondTarget - firstTarget) / (secondSource - firstSource));
+
+	return SubtitlesRetimer(scale, (firstTarget - (firstSource * scale)));
+}
@@ -0,0 +1,50 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESRETIMER_H
+#define SUBTITLESRETIMER_H
+
+#include <QtCore/QVector>
+
+class SubtitlesRetimer
+{
+public:
+	explicit SubtitlesRetimer(double scale = 1, double offset = 0);
+
+	void apply(qint64 *times, int count) const;
+	void apply(const qint64 *input, qint64 *output, int count) const;
+	void apply(QVector<qint64> *begins, QVector<qint64> *ends, int first, int last) const;
+	qint64 apply(qint64 time) const;
+	double scale() const;
+	double offset() const;
+	bool isIdentity() const;
+	bool isValid() const;
+	static SubtitlesRetimer shift(qint64 offset);
+	static SubtitlesRetimer rescale(double scale);
+	static SubtitlesRetimer convertFrameRate(double sourceRate, double targetRate);
+	static SubtitlesRetimer fit(qint64 firstSource, qint64 firstTarget, qint64 secondSource, qint64 secondTarget);
+
+private:
+	double m_scale;
+	double m_offset;
+};
+
+#endif
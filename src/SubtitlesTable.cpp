@@ -0,0 +1,268 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesTable.h"
+#include "SubtitlesModel.h"
+#include "TimeSpinBox.h"
+
+#include <QtCore/QSortFilterProxyModel>
+#include <QtCore/QTimer>
+#include <QtWidgets/QAction>
+#include <QtWidgets/QHeaderView>
+#include <QtWidgets/QInputDialog>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QLineEdit>
+#include <QtWidgets/QStyledItemDelegate>
+#include <QtWidgets/QTableView>
+#include <QtWidgets/QVBoxLayout>
+
+#include <algorithm>
+
+class TimeItemDelegate : public QStyledItemDelegate
+{
+public:
+	explicit TimeItemDelegate(QObject *parent) : QStyledItemDelegate(parent)
+	{
+	}
+
+	QWidget* createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const
+	{
+		Q_UNUSED(option)
+		Q_UNUSED(index)
+
+		return new TimeSpinBox(parent);
+	}
+
+	void setEditorData(QWidget *editor, const QModelIndex &index) const
+	{
+		static_cast<TimeSpinBox*>(editor)->setTime(index.data(Qt::EditRole).toLongLong());
+	}
+
+	void setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const
+	{
+		TimeSpinBox *timeSpinBox = static_cast<TimeSpinBox*>(editor);
+		timeSpinBox->interpretText();
+
+		model->setData(index, timeSpinBox->time(), Qt::EditRole);
+	}
+};
+
+SubtitlesTable::SubtitlesTable(QWidget *parent) : QWidget(parent),
+	m_tableView(new QTableView(this)),
+	m_filterLineEdit(new QLineEdit(this)),
+	m_statusLabel(new QLabel(this)),
+	m_filterTimer(new QTimer(this)),
+	m_proxyModel(new QSortFilterProxyModel(this)),
+	m_model(NULL),
+	m_updating(false)
+{
+	m_filterLineEdit->setPlaceholderText(tr("Filter subtitles"));
+	m_filterLineEdit->setClearButtonEnabled(true);
+
+	m_filterTimer->setSingleShot(true);
+	m_filterTimer->setInterval(150);
+
+	m_proxyModel->setSortRole(SubtitlesModel::SortRole);
+	m_proxyModel->setFilterRole(SubtitlesModel::SortRole);
+	m_proxyModel->setFilterKeyColumn(SubtitlesModel::TextColumn);
+	m_proxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
+
+	TimeItemDelegate *timeDelegate = new TimeItemDelegate(m_tableView);
+
+	m_tableView->setModel(m_proxyModel);
+	m_tableView->setItemDelegateForColumn(SubtitlesModel::BeginColumn, timeDelegate);
+	m_tableView->setItemDelegateForColumn(SubtitlesModel::EndColumn, timeDelegate);
+	m_tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+	m_tableView->setWordWrap(false);
+	m_tableView->setAlternatingRowColors(true);
+	m_tableView->setContextMenuPolicy(Qt::ActionsContextMenu);
+	m_tableView->verticalHeader()->hide();
+	m_tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+	m_tableView->verticalHeader()->setDefaultSectionSize(fontMetrics().height() + 6);
+	m_tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+	m_tableView->horizontalHeader()->setStretchLastSection(false);
+	m_tableView->horizontalHeader()->setDefaultSectionSize(fontMetrics().horizontalAdvance("000:00.0") + 20);
+	m_tableView->setSortingEnabled(true);
+	m_tableView->sortByColumn(SubtitlesModel::BeginColumn, Qt::AscendingOrder);
+
+	QAction *shiftTimesAction = new QAction(tr("Shift Times..."), m_tableView);
+	QAction *horizontalPositionAction = new QAction(tr("Set Horizontal Position..."), m_tableView);
+	QAction *verticalPositionAction = new QAction(tr("Set Vertical Position..."), m_tableView);
+
+	m_tableView->addAction(shiftTimesAction);
+	m_tableView->addAction(horizontalPositionAction);
+	m_tableView->addAction(verticalPositionAction);
+
+	QVBoxLayout *mainLayout = new QVBoxLayout(this);
+	mainLayout->setContentsMargins(0, 0, 0, 0);
+	mainLayout->setSpacing(0);
+	mainLayout->addWidget(m_filterLineEdit);
+	mainLayout->addWidget(m_tableView);
+	mainLayout->addWidget(m_statusLabel);
+
+	connect(m_filterLineEdit, SIGNAL(textChanged(QString)), m_filterTimer, SLOT(start()));
+	connect(m_filterTimer, SIGNAL(timeout()), this, SLOT(updateFilter()));
+	connect(m_tableView->selectionModel(), SIGNAL(currentRowChanged(QModelIndex,QModelIndex)), this, SLOT(currentRowChanged(QModelIndex)));
+	connect(m_proxyModel, SIGNAL(modelReset()), this, SLOT(updateStatus()));
+	connect(m_proxyModel, SIGNAL(layoutChanged()), this, SLOT(updateStatus()));
+	connect(m_proxyModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)), this, SLOT(updateStatus()));
+	connect(m_proxyModel, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(updateStatus()));
+	connect(m_proxyModel, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(updateStatus()));
+	connect(shiftTimesAction, SIGNAL(triggered()), this, SLOT(shiftTimes()));
+	connect(horizontalPositionAction, SIGNAL(triggered()), this, SLOT(setHorizontalPosition()));
+	connect(verticalPositionAction, SIGNAL(triggered()), this, SLOT(setVerticalPosition()));
+}
+
+void SubtitlesTable::setModel(SubtitlesModel *model)
+{
+	m_model = model;
+
+	m_proxyModel->setSourceModel(model);
+	m_tableView->horizontalHeader()->setSectionResizeMode(SubtitlesModel::TextColumn, QHeaderView::Stretch);
+
+	updateStatus();
+}
+
+void SubtitlesTable::setCurrentSubtitle(int track, int subtitle)
+{
+	if (!m_model || track != m_model->track())
+	{
+		return;
+	}
+
+	const QModelIndex index = m_proxyModel->mapFromSource(m_model->index(subtitle, 0));
+
+	if (!index.isValid() || index.row() == m_tableView->currentIndex().row())
+	{
+		return;
+	}
+
+	m_updating = true;
+
+	m_tableView->setCurrentIndex(index);
+	m_tableView->scrollTo(index);
+
+	m_updating = false;
+}
+
+void SubtitlesTable::updateFilter()
+{
+	m_proxyModel->setFilterFixedString(m_filterLineEdit->text());
+}
+
+void SubtitlesTable::updateStatus()
+{
+	const int total = (m_model ? m_model->rowCount() : 0);
+	const int visible = m_proxyModel->rowCount();
+	QString status = ((visible == total) ? tr("%n subtitle(s)", "", total) : tr("%1 of %n subtitle(s)", "", total).arg(visible));
+
+	if (m_model && m_model->problemCount() > 0)
+	{
+		status.append(QLatin1String(", ") + tr("%n with problems", "", m_model->problemCount()));
+	}
+
+	m_statusLabel->setText(status);
+}
+
+void SubtitlesTable::currentRowChanged(const QModelIndex &index)
+{
+	if (!m_updating && m_model && index.isValid())
+	{
+		emit subtitleSelected(m_model->track(), m_proxyModel->mapToSource(index).row());
+	}
+}
+
+void SubtitlesTable::shiftTimes()
+{
+	const QVector<int> rows = selectedRows();
+	bool ok = false;
+
+	if (rows.isEmpty())
+	{
+		return;
+	}
+
+	const int offset = QInputDialog::getInt(this, tr("Shift Times"), tr("Milliseconds to add to %n selected subtitle(s):", "", rows.count()), 0, -86400000, 86400000, 100, &ok);
+
+	if (ok)
+	{
+		m_model->shiftTimes(rows, offset);
+	}
+}
+
+void SubtitlesTable::setHorizontalPosition()
+{
+	const QVector<int> rows = selectedRows();
+	bool ok = false;
+
+	if (rows.isEmpty())
+	{
+		return;
+	}
+
+	const int position = QInputDialog::getInt(this, tr("Set Horizontal Position"), tr("Horizontal position of %n selected subtitle(s):", "", rows.count()), m_model->index(rows.first(), SubtitlesModel::XPositionColumn).data().toInt(), 0, 10000, 1, &ok);
+
+	if (ok)
+	{
+		m_model->setColumnData(rows, SubtitlesModel::XPositionColumn, position);
+	}
+}
+
+void SubtitlesTable::setVerticalPosition()
+{
+	const QVector<int> rows = selectedRows();
+	bool ok = false;
+
+	if (rows.isEmpty())
+	{
+		return;
+	}
+
+	const int position = QInputDialog::getInt(this, tr("Set Vertical Position"), tr("Vertical position of %n selected subtitle(s):", "", rows.count()), m_model->index(rows.first(), SubtitlesModel::YPositionColumn).data().toInt(), 0, 10000, 1, &ok);
+
+	if (ok)
+	{
+		m_model->setColumnData(rows, SubtitlesModel::YPositionColumn, position);
+	}
+}
+
+QVector<int> SubtitlesTable::selectedRows() const
+{
+	QVector<int> rows;
+
+	if (!m_model)
+	{
+		return rows;
+	}
+
+	const QModelIndexList indexes = m_tableView->selectionModel()->selectedRows();
+
+	rows.reserve(indexes.count());
+
+	for (int i = 0; i < indexes.count(); ++i)
+	{
+		rows.append(m_proxyModel->mapToSource(indexes.at(i)).row());
+	}
+
+	std::sort(rows.begin(), rows.end());
+
+	return rows;
+}
@@ -0,0 +1,72 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESTABLE_H
+#define SUBTITLESTABLE_H
+
+#include <QtCore/QModelIndex>
+#include <QtCore/QVector>
+#include <QtWidgets/QWidget>
+
+class QLabel;
+class QLineEdit;
+class QSortFilterProxyModel;
+class QTableView;
+class QTimer;
+
+class SubtitlesModel;
+
+class SubtitlesTable : public QWidget
+{
+	Q_OBJECT
+
+public:
+	explicit SubtitlesTable(QWidget *parent = NULL);
+
+	void setModel(SubtitlesModel *model);
+	QVector<int> selectedRows() const;
+
+public slots:
+	void setCurrentSubtitle(int track, int subtitle);
+
+protected slots:
+	void updateFilter();
+	void updateStatus();
+	void currentRowChanged(const QModelIndex &index);
+	void shiftTimes();
+	void setHorizontalPosition();
+	void setVerticalPosition();
+
+private:
+	QTableView *m_tableView;
+	QLineEdit *m_filterLineEdit;
+	QLabel *m_statusLabel;
+	QTimer *m_filterTimer;
+	QSortFilterProxyModel *m_proxyModel;
+	SubtitlesModel *m_model;
+	bool m_updating;
+
+signals:
+	void subtitleSelected(int track, int subtitle);
+
+};
+
+#endif
@@ -0,0 +1,200 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesTextStore.h"
+
+#include <QtCore/QHash>
+
+#include <algorithm>
+
+SubtitlesTextStore::SubtitlesTextStore() : m_textSize(0)
+{
+}
+
+void SubtitlesTextStore::clear()
+{
+	m_blocks.clear();
+	m_entries.clear();
+	m_slots.clear();
+	m_textSize = 0;
+}
+
+quint32 SubtitlesTextStore::intern(const QString &text)
+{
+	const uint hash = qHashBits(text.constData(), (text.length() * sizeof(QChar)));
+	const quint32 existing = lookup(text.constData(), text.length(), hash);
+
+	if (existing != InvalidHandle)
+	{
+		return existing;
+	}
+
+	if ((m_entries.count() + 1) * 2 > m_slots.count())
+	{
+		rehash(qMax(1024, (m_slots.count() * 2)));
+	}
+
+	if (m_blocks.isEmpty() || (m_blocks.last().capacity() - m_blocks.last().count()) < text.length())
+	{
+		m_blocks.append(QVector<QChar>());
+		m_blocks.last().reserve(qMax(int(BlockSize), text.length()));
+	}
+
+	QVector<QChar> &block = m_blocks.last();
+	Entry entry;
+	entry.block = (m_blocks.count() - 1);
+	entry.offset = block.count();
+	entry.length = text.length();
+	entry.hash = hash;
+
+	block.resize(entry.offset + entry.length);
+
+	std::copy(text.constData(), (text.constData() + text.length()), (block.data() + entry.offset));
+
+	const quint32 handle = m_entries.count();
+	const int mask = (m_slots.count() - 1);
+	int slot = (hash & mask);
+
+	while (m_slots.at(slot) != 0)
+	{
+		slot = ((slot + 1) & mask);
+	}
+
+	m_slots[slot] = (handle + 1);
+	m_entries.append(entry);
+	m_textSize += text.length();
+
+	return handle;
+}
+
+quint32 SubtitlesTextStore::find(const QString &text) const
+{
+	return lookup(text.constData(), text.length(), qHashBits(text.constData(), (text.length() * sizeof(QChar))));
+}
+
+quint32 SubtitlesTextStore::lookup(const QChar *text, int length, uint hash) const
+{
+	if (m_slots.isEmpty())
+	{
+		return InvalidHandle;
+	}
+
+	const int mask = (m_slots.count() - 1);
+	int slot = (hash & mask);
+
+	while (m_slots.at(slot) != 0)
+	{
+		const quint32 handle = (m_slots.at(slot) - 1);
+		const Entry &entry = m_entries.at(handle);
+
+		if (entry.hash == hash && equals(entry, text, length))
+		{
+			return handle;
+		}
+
+		slot = ((slot + 1) & mask);
+	}
+
+	return InvalidHandle;
+}
+
+void SubtitlesTextStore::rehash(int size)
+{
+	m_slots = QVector<quint32>(size, 0);
+
+	const int mask = (size - 1);
+
+	for (int i = 0; i < m_entries.count(); ++i)
+	{
+		int slot = (m_entries.at(i).hash & mask);
+
+		while (m_slots.at(slot) != 0)
+		{
+			slot = ((slot + 1) & mask);
+		}
+
+		m_slots[slot] = (i + 1);
+	}
+}
+
+bool SubtitlesTextStore::equals(const Entry &entry, const QChar *text, int length) const
+{
+	if (int(entry.length) != length)
+	{
+		return false;
+	}
+
+	const QChar *stored = (m_blocks.at(entry.block).constData() + entry.offset);
+
+	for (int i = 0; i < length; ++i)
+	{
+		if (stored[i] != text[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+QString SubtitlesTextStore::text(quint32 handle) const
+{
+	if (handle >= quint32(m_entries.count()))
+	{
+		return QString();
+	}
+
+	return QString(data(handle), length(handle));
+}
+
+const QChar* SubtitlesTextStore::data(quint32 handle) const
+{
+	const Entry &entry = m_entries.at(handle);
+
+	return (m_blocks.at(entry.block).constData() + entry.offset);
+}
+
+int SubtitlesTextStore::length(quint32 handle) const
+{
+	return m_entries.at(handle).length;
+}
+
+int SubtitlesTextStore::count() const
+{
+	return m_entries.count();
+}
+
+qint64 SubtitlesTextStore::textSize() const
+{
+	return (m_textSize * sizeof(QChar));
+}
+
+qint64 SubtitlesTextStore::memoryUsage() const
+{
+	qint64 usage = ((m_entries.capacity() * sizeof(Entry)) + (m_slots.capacity() * sizeof(quint32)));
+
+	for (int i = 0; i < m_blocks.count(); ++i)
+	{
+		usage += (m_blocks.at(i).capacity() * sizeof(QChar));
+	}
+
+	return usage;
+}
@@ -0,0 +1,70 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESTEXTSTORE_H
+#define SUBTITLESTEXTSTORE_H
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+class SubtitlesTextStore
+{
+public:
+	enum
+	{
+		BlockSize = 65536,
+		InvalidHandle = 0xFFFFFFFF
+	};
+
+	SubtitlesTextStore();
+
+	void clear();
+	quint32 intern(const QString &text);
+	quint32 find(const QString &text) const;
+	QString text(quint32 handle) const;
+	const QChar* data(quint32 handle) const;
+	int length(quint32 handle) const;
+	int count() const;
+	qint64 textSize() const;
+	qint64 memoryUsage() const;
+
+protected:
+	struct Entry
+	{
+		quint32 block;
+		quint32 offset;
+		quint32 length;
+		uint hash;
+	};
+
+	quint32 lookup(const QChar *text, int length, uint hash) const;
+	void rehash(int size);
+	bool equals(const Entry &entry, const QChar *text, int length) const;
+
+private:
+	QList<QVector<QChar> > m_blocks;
+	QVector<Entry> m_entries;
+	QVector<quint32> m_slots;
+	qint64 m_textSize;
+};
+
+#endif
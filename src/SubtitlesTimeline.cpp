@@ -0,0 +1,765 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesTimeline.h"
+#include "SubtitlesWriter.h"
+
+#include <QtGui/QMouseEvent>
+#include <QtGui/QPainter>
+#include <QtGui/QWheelEvent>
+
+#include <algorithm>
+#include <cmath>
+
+struct BeginLessThan
+{
+	explicit BeginLessThan(const qint64 *begins) : m_begins(begins)
+	{
+	}
+
+	bool operator()(int first, int second) const
+	{
+		return (m_begins[first] < m_begins[second] || (m_begins[first] == m_begins[second] && first < second));
+	}
+
+	bool operator()(int subtitle, qint64 time) const
+	{
+		return (m_begins[subtitle] < time);
+	}
+
+	const qint64 *m_begins;
+};
+
+SubtitlesTimeline::SubtitlesTimeline(QWidget *parent) : QWidget(parent),
+	m_tracks(NULL),
+	m_waveform(NULL),
+	m_duration(0),
+	m_contentDuration(0),
+	m_position(0),
+	m_viewBegin(0),
+	m_scale(100),
+	m_currentTrack(-1),
+	m_currentSubtitle(-1),
+	m_dragMode(NoDrag),
+	m_dragTrack(-1),
+	m_dragSubtitle(-1),
+	m_dragTime(0),
+	m_dragBegin(0),
+	m_dragEnd(0),
+	m_ordersValid(false),
+	m_fitted(true)
+{
+	setAttribute(Qt::WA_OpaquePaintEvent);
+	setMouseTracking(true);
+	setMinimumHeight(RulerHeight + 40);
+}
+
+void SubtitlesTimeline::setTracks(const QList<SubtitlesTrack> *tracks)
+{
+	m_tracks = tracks;
+
+	tracksChanged();
+}
+
+void SubtitlesTimeline::setWaveform(const WaveformPeaks *waveform)
+{
+	m_waveform = waveform;
+
+	update();
+}
+
+void SubtitlesTimeline::setDuration(qint64 duration)
+{
+	m_duration = duration;
+
+	if (m_fitted)
+	{
+		zoomToFit();
+	}
+	else
+	{
+		setView(m_viewBegin, m_scale);
+	}
+}
+
+void SubtitlesTimeline::setPosition(qint64 position)
+{
+	if (position == m_position)
+	{
+		return;
+	}
+
+	const int oldPixel = pixelAt(m_position);
+
+	m_position = position;
+
+	const qint64 viewEnd = timeAt(width());
+
+	if (m_dragMode == NoDrag && !m_fitted && (position < m_viewBegin || position > viewEnd))
+	{
+		setView((position - qint64((width() * m_scale) / 10)), m_scale);
+
+		return;
+	}
+
+	const int newPixel = pixelAt(m_position);
+
+	if (newPixel != oldPixel)
+	{
+		update((oldPixel - 1), 0, 3, height());
+		update((newPixel - 1), 0, 3, height());
+	}
+}
+
+void SubtitlesTimeline::setCurrentSubtitle(int track, int subtitle)
+{
+	if (track != m_currentTrack || subtitle != m_currentSubtitle)
+	{
+		m_currentTrack = track;
+		m_currentSubtitle = subtitle;
+
+		update();
+	}
+}
+
+void SubtitlesTimeline::tracksChanged()
+{
+	m_ordersValid = false;
+	m_validOrders.clear();
+
+	contentChanged();
+}
+
+void SubtitlesTimeline::trackChanged(int track)
+{
+	if (track >= 0 && track < m_validOrders.count())
+	{
+		m_ordersValid = false;
+		m_validOrders[track] = false;
+	}
+
+	contentChanged();
+}
+
+void SubtitlesTimeline::subtitlesChanged(int track, int first, int last)
+{
+	if (!m_tracks || track < 0 || track >= m_validOrders.count() || !m_validOrders.at(track))
+	{
+		update();
+
+		return;
+	}
+
+	const SubtitlesTrack &data = m_tracks->at(track);
+
+	if (data.count() != m_begins.at(track).count())
+	{
+		trackChanged(track);
+
+		return;
+	}
+
+	const QVector<qint64> &begins = m_begins.at(track);
+	const QVector<qint64> &ends = m_ends.at(track);
+	QVector<int> retimed;
+
+	for (int i = qMax(0, first); i <= qMin(last, (data.count() - 1)); ++i)
+	{
+		if (data.begin(i) != begins.at(i) || data.end(i) != ends.at(i))
+		{
+			retimed.append(i);
+
+			if (retimed.count() > 1)
+			{
+				trackChanged(track);
+
+				return;
+			}
+		}
+	}
+
+	if (retimed.isEmpty())
+	{
+		update();
+
+		return;
+	}
+
+	moveSubtitle(track, retimed.first());
+	updateContentDuration();
+	contentChanged();
+}
+
+void SubtitlesTimeline::waveformChanged()
+{
+	update();
+}
+
+void SubtitlesTimeline::zoomIn()
+{
+	const qint64 center = timeAt(width() / 2);
+	const double scale = (m_scale / 1.5);
+
+	m_fitted = false;
+
+	setView((center - qint64((width() / 2) * scale)), scale);
+}
+
+void SubtitlesTimeline::zoomOut()
+{
+	const qint64 center = timeAt(width() / 2);
+	const double scale = (m_scale * 1.5);
+
+	m_fitted = false;
+
+	setView((center - qint64((width() / 2) * scale)), scale);
+}
+
+void SubtitlesTimeline::zoomToFit()
+{
+	ensureOrders();
+
+	m_fitted = true;
+	m_viewBegin = 0;
+	m_scale = (double(qMax(duration(), qint64(1000))) / qMax(1, width()));
+
+	update();
+}
+
+void SubtitlesTimeline::setView(qint64 begin, double scale)
+{
+	const double maximumScale = (double(qMax(duration(), qint64(1000))) / qMax(1, width()));
+
+	m_scale = qBound(1.0, scale, qMax(1.0, maximumScale));
+	m_viewBegin = qBound(qint64(0), begin, qMax(qint64(0), (duration() - qint64(width() * m_scale))));
+	m_fitted = (m_fitted || m_scale >= maximumScale);
+
+	update();
+}
+
+void SubtitlesTimeline::contentChanged()
+{
+	if (m_fitted)
+	{
+		zoomToFit();
+	}
+	else
+	{
+		update();
+	}
+}
+
+void SubtitlesTimeline::ensureOrders()
+{
+	if (m_ordersValid)
+	{
+		return;
+	}
+
+	const int tracks = (m_tracks ? m_tracks->count() : 0);
+
+	if (m_validOrders.count() != tracks)
+	{
+		m_validOrders.fill(false, tracks);
+	}
+
+	m_orders.resize(tracks);
+	m_begins.resize(tracks);
+	m_ends.resize(tracks);
+	m_maximumEnds.resize(tracks);
+
+	for (int i = 0; i < tracks; ++i)
+	{
+		if (!m_validOrders.at(i))
+		{
+			buildOrder(i);
+		}
+	}
+
+	updateContentDuration();
+
+	m_ordersValid = true;
+}
+
+void SubtitlesTimeline::buildOrder(int track)
+{
+	const SubtitlesTrack &data = m_tracks->at(track);
+	QVector<int> &order = m_orders[track];
+	QVector<qint64> &begins = m_begins[track];
+	QVector<qint64> &ends = m_ends[track];
+	QVector<qint64> &maximumEnds = m_maximumEnds[track];
+	bool sorted = true;
+
+	order.resize(data.count());
+	begins.resize(data.count());
+	ends.resize(data.count());
+	maximumEnds.resize(data.count());
+
+	for (int i = 0; i < data.count(); ++i)
+	{
+		order[i] = i;
+		begins[i] = data.begins()[i];
+		ends[i] = data.ends()[i];
+
+		if (i > 0 && begins.at(i) < begins.at(i - 1))
+		{
+			sorted = false;
+		}
+	}
+
+	if (!sorted)
+	{
+		std::sort(order.begin(), order.end(), BeginLessThan(begins.constData()));
+	}
+
+	qint64 maximumEnd = 0;
+
+	for (int i = 0; i < order.count(); ++i)
+	{
+		maximumEnd = qMax(maximumEnd, ends.at(order.at(i)));
+		maximumEnds[i] = maximumEnd;
+	}
+
+	m_validOrders[track] = true;
+}
+
+void SubtitlesTimeline::moveSubtitle(int track, int subtitle)
+{
+	const SubtitlesTrack &data = m_tracks->at(track);
+	QVector<int> &order = m_orders[track];
+	QVector<qint64> &begins = m_begins[track];
+	QVector<qint64> &ends = m_ends[track];
+	QVector<qint64> &maximumEnds = m_maximumEnds[track];
+	const int from = (std::lower_bound(order.constBegin(), order.constEnd(), subtitle, BeginLessThan(begins.constData())) - order.constBegin());
+
+	order.remove(from);
+
+	begins[subtitle] = data.begin(subtitle);
+	ends[subtitle] = data.end(subtitle);
+
+	const int to = (std::lower_bound(order.constBegin(), order.constEnd(), subtitle, BeginLessThan(begins.constData())) - order.constBegin());
+
+	order.insert(to, subtitle);
+
+	const int changedFirst = qMin(from, to);
+	const int changedLast = qMax(from, to);
+	qint64 maximumEnd = ((changedFirst > 0) ? maximumEnds.at(changedFirst - 1) : 0);
+
+	for (int i = changedFirst; i < order.count(); ++i)
+	{
+		maximumEnd = qMax(maximumEnd, ends.at(order.at(i)));
+
+		if (i > changedLast && maximumEnds.at(i) == maximumEnd)
+		{
+			break;
+		}
+
+		maximumEnds[i] = maximumEnd;
+	}
+}
+
+void SubtitlesTimeline::updateContentDuration()
+{
+	m_contentDuration = 0;
+
+	for (int i = 0; i < m_maximumEnds.count(); ++i)
+	{
+		if (!m_maximumEnds.at(i).isEmpty())
+		{
+			m_contentDuration = qMax(m_contentDuration, m_maximumEnds.at(i).last());
+		}
+	}
+}
+
+void SubtitlesTimeline::visibleRange(int track, qint64 begin, qint64 end, int *first, int *last) const
+{
+	const QVector<int> &order = m_orders.at(track);
+	const QVector<qint64> &maximumEnds = m_maximumEnds.at(track);
+
+	*first = (std::upper_bound(maximumEnds.constBegin(), maximumEnds.constEnd(), begin) - maximumEnds.constBegin());
+	*last = (std::lower_bound((order.constBegin() + *first), order.constEnd(), end, BeginLessThan(m_begins.at(track).constData())) - order.constBegin());
+}
+
+void SubtitlesTimeline::paintEvent(QPaintEvent *event)
+{
+	ensureOrders();
+
+	static const qint64 steps[] = {100, 250, 500, 1000, 2000, 5000, 10000, 15000, 30000, 60000, 120000, 300000, 600000, 1800000, 3600000};
+	const QRect area = event->rect();
+	const qint64 paintBegin = timeAt(area.left() - 1);
+	const qint64 paintEnd = timeAt(area.right() + 2);
+	qint64 step = steps[(sizeof(steps) / sizeof(steps[0])) - 1];
+	char buffer[32];
+	QPainter painter(this);
+	painter.fillRect(area, palette().color(QPalette::Base));
+	painter.fillRect(QRect(0, 0, width(), RulerHeight).intersected(area), palette().color(QPalette::Window));
+	painter.setPen(palette().color(QPalette::WindowText));
+
+	for (unsigned int i = 0; i < (sizeof(steps) / sizeof(steps[0])); ++i)
+	{
+		if (steps[i] >= (80 * m_scale))
+		{
+			step = steps[i];
+
+			break;
+		}
+	}
+
+	for (qint64 time = ((qMax(qint64(0), timeAt(area.left() - 100)) / step) * step); time <= paintEnd; time += step)
+	{
+		const int x = pixelAt(time);
+
+		painter.drawLine(x, (RulerHeight - 5), x, (RulerHeight - 1));
+		painter.drawText((x + 3), 0, 100, (RulerHeight - 2), (Qt::AlignLeft | Qt::AlignVCenter), QString::fromLatin1(buffer, SubtitlesWriter::formatTime(time, buffer, true)));
+	}
+
+	for (int i = 1; i < m_orders.count(); i += 2)
+	{
+		painter.fillRect(trackRect(i).intersected(area), palette().color(QPalette::AlternateBase));
+	}
+
+	if (m_waveform && !m_waveform->isEmpty())
+	{
+		const int center = ((RulerHeight + height()) / 2);
+		const double amplitude = ((height() - RulerHeight) / 65536.0);
+		QVector<QLine> lines;
+		lines.reserve(area.width() + 2);
+
+		for (int x = (area.left() - 1); x <= (area.right() + 1); ++x)
+		{
+			qint16 minimum = 0;
+			qint16 maximum = 0;
+
+			if (m_waveform->peak(timeAt(x), timeAt(x + 1), &minimum, &maximum))
+			{
+				lines.append(QLine(x, (center - int(maximum * amplitude)), x, (center - int(minimum * amplitude))));
+			}
+		}
+
+		painter.setPen(palette().color(QPalette::Mid));
+		painter.drawLines(lines);
+	}
+
+	for (int i = 0; i < m_orders.count(); ++i)
+	{
+		const QRect blocks = trackRect(i).adjusted(0, 2, 0, -2);
+		const QColor color = ((i % 2) ? QColor(60, 150, 110) : QColor(70, 120, 180));
+		const SubtitlesTrack &track = m_tracks->at(i);
+		const QVector<int> &order = m_orders.at(i);
+		QVector<int> buckets(((width() / BucketWidth) + 1), 0);
+		int first = 0;
+		int last = 0;
+
+		visibleRange(i, paintBegin, paintEnd, &first, &last);
+
+		for (int j = first; j < last; ++j)
+		{
+			const int subtitle = order.at(j);
+
+			if (track.end(subtitle) <= paintBegin)
+			{
+				continue;
+			}
+
+			const int left = pixelAt(track.begin(subtitle));
+			const int right = pixelAt(track.end(subtitle));
+			const bool current = (i == m_currentTrack && subtitle == m_currentSubtitle);
+
+			if ((right - left) < MinimumBlockWidth && !current)
+			{
+				for (int k = qMax(0, (left / BucketWidth)); k <= qMin((buckets.count() - 1), (right / BucketWidth)); ++k)
+				{
+					++buckets[k];
+				}
+
+				continue;
+			}
+
+			const QRect block(QPoint(qMax(-1, left), blocks.top()), QPoint(qMin(width(), qMax(left, right)), blocks.bottom()));
+
+			painter.fillRect(block, (current ? palette().color(QPalette::Highlight) : color));
+			painter.setPen(color.darker(150));
+			painter.drawRect(block.adjusted(0, 0, -1, -1));
+
+			if (block.width() > 24)
+			{
+				QString text = track.text(subtitle);
+				text.replace('\n', ' ');
+
+				painter.setPen(current ? palette().color(QPalette::HighlightedText) : QColor(Qt::white));
+				painter.drawText(block.adjusted(4, 0, -4, 0), (Qt::AlignLeft | Qt::AlignVCenter), fontMetrics().elidedText(text, Qt::ElideRight, (block.width() - 8)));
+			}
+		}
+
+		const QColor aggregateColor = color.lighter(120);
+
+		for (int j = 0; j < buckets.count(); ++j)
+		{
+			if (buckets.at(j) > 0)
+			{
+				const int barHeight = ((blocks.height() * (2 + qMin(buckets.at(j), 8))) / 10);
+
+				painter.fillRect((j * BucketWidth), (blocks.bottom() - barHeight + 1), BucketWidth, barHeight, aggregateColor);
+			}
+		}
+	}
+
+	const int playhead = pixelAt(m_position);
+
+	painter.setPen(QColor(220, 40, 40));
+	painter.drawLine(playhead, 0, playhead, height());
+}
+
+void SubtitlesTimeline::resizeEvent(QResizeEvent *event)
+{
+	QWidget::resizeEvent(event);
+
+	if (m_fitted)
+	{
+		zoomToFit();
+	}
+	else
+	{
+		setView(m_viewBegin, m_scale);
+	}
+}
+
+void SubtitlesTimeline::mousePressEvent(QMouseEvent *event)
+{
+	if (event->button() != Qt::LeftButton)
+	{
+		QWidget::mousePressEvent(event);
+
+		return;
+	}
+
+	int track = -1;
+	int subtitle = -1;
+
+	m_dragMode = hitTest(event->pos(), &track, &subtitle);
+
+	if (m_dragMode == SeekDrag)
+	{
+		emit positionRequested(timeAt(event->x()));
+	}
+	else if (m_dragMode != NoDrag)
+	{
+		m_dragTrack = track;
+		m_dragSubtitle = subtitle;
+		m_dragTime = timeAt(event->x());
+		m_dragBegin = m_tracks->at(track).begin(subtitle);
+		m_dragEnd = m_tracks->at(track).end(subtitle);
+
+		emit subtitleSelected(track, subtitle);
+	}
+}
+
+void SubtitlesTimeline::mouseMoveEvent(QMouseEvent *event)
+{
+	if (m_dragMode == NoDrag)
+	{
+		int track = -1;
+		int subtitle = -1;
+
+		switch (hitTest(event->pos(), &track, &subtitle))
+		{
+			case BeginDrag:
+			case EndDrag:
+				setCursor(Qt::SizeHorCursor);
+
+				break;
+			case MoveDrag:
+				setCursor(Qt::SizeAllCursor);
+
+				break;
+			default:
+				unsetCursor();
+
+				break;
+		}
+
+		return;
+	}
+
+	if (m_dragMode == SeekDrag)
+	{
+		emit positionRequested(qMax(qint64(0), timeAt(event->x())));
+
+		return;
+	}
+
+	const qint64 delta = (timeAt(event->x()) - m_dragTime);
+	qint64 begin = m_dragBegin;
+	qint64 end = m_dragEnd;
+
+	switch (m_dragMode)
+	{
+		case MoveDrag:
+			begin = qMax(qint64(0), (m_dragBegin + delta));
+			end = (begin + (m_dragEnd - m_dragBegin));
+
+			break;
+		case BeginDrag:
+			begin = qBound(qint64(0), (m_dragBegin + delta), qMax(qint64(0), (m_dragEnd - MinimumLength)));
+
+			break;
+		case EndDrag:
+			end = qMax((m_dragBegin + MinimumLength), (m_dragEnd + delta));
+
+			break;
+		default:
+			break;
+	}
+
+	if (begin != m_tracks->at(m_dragTrack).begin(m_dragSubtitle) || end != m_tracks->at(m_dragTrack).end(m_dragSubtitle))
+	{
+		emit subtitleRetimed(m_dragTrack, m_dragSubtitle, begin, end);
+	}
+}
+
+void SubtitlesTimeline::mouseReleaseEvent(QMouseEvent *event)
+{
+	if (m_dragMode == MoveDrag || m_dragMode == BeginDrag || m_dragMode == EndDrag)
+	{
+		emit retimeFinished();
+	}
+
+	m_dragMode = NoDrag;
+	m_dragTrack = -1;
+	m_dragSubtitle = -1;
+
+	QWidget::mouseReleaseEvent(event);
+}
+
+void SubtitlesTimeline::wheelEvent(QWheelEvent *event)
+{
+	const QPoint delta = event->angleDelta();
+
+	if ((event->modifiers() & Qt::ShiftModifier) || delta.x() != 0)
+	{
+		const int steps = ((delta.x() != 0) ? delta.x() : delta.y());
+
+		m_fitted = false;
+
+		setView((m_viewBegin - qint64(((steps / 120.0) * width() * m_scale) / 8)), m_scale);
+	}
+	else
+	{
+		const qint64 anchor = timeAt(event->pos().x());
+		const double scale = (m_scale * std::pow(1.25, (-delta.y() / 120.0)));
+
+		m_fitted = false;
+
+		setView((anchor - qint64(event->pos().x() * scale)), scale);
+	}
+
+	event->accept();
+}
+
+SubtitlesTimeline::DragMode SubtitlesTimeline::hitTest(const QPoint &point, int *track, int *subtitle) const
+{
+	*track = trackAt(point.y());
+	*subtitle = -1;
+
+	if (*track < 0 || *track >= m_validOrders.count() || !m_validOrders.at(*track))
+	{
+		return ((point.y() < RulerHeight) ? SeekDrag : NoDrag);
+	}
+
+	const qint64 time = timeAt(point.x());
+	const qint64 tolerance = qint64((HandleWidth + 1) * m_scale);
+	const SubtitlesTrack &data = m_tracks->at(*track);
+	const QVector<int> &order = m_orders.at(*track);
+	int first = 0;
+	int last = 0;
+
+	visibleRange(*track, (time - tolerance), (time + tolerance + 1), &first, &last);
+
+	for (int i = (last - 1); i >= first; --i)
+	{
+		const int left = pixelAt(data.begin(order.at(i)));
+		const int right = pixelAt(data.end(order.at(i)));
+
+		if ((right - left) < MinimumBlockWidth || point.x() < (left - HandleWidth) || point.x() > (right + HandleWidth))
+		{
+			continue;
+		}
+
+		*subtitle = order.at(i);
+
+		if (qAbs(point.x() - left) <= HandleWidth)
+		{
+			return BeginDrag;
+		}
+
+		if (qAbs(point.x() - right) <= HandleWidth)
+		{
+			return EndDrag;
+		}
+
+		return MoveDrag;
+	}
+
+	return SeekDrag;
+}
+
+QRect SubtitlesTimeline::trackRect(int track) const
+{
+	const int rows = qMax(1, m_orders.count());
+	const int rowHeight = ((height() - RulerHeight) / rows);
+
+	return QRect(0, (RulerHeight + (track * rowHeight)), width(), rowHeight);
+}
+
+int SubtitlesTimeline::trackAt(int y) const
+{
+	if (y < RulerHeight || m_orders.isEmpty())
+	{
+		return -1;
+	}
+
+	return qMin((m_orders.count() - 1), ((y - RulerHeight) / qMax(1, ((height() - RulerHeight) / m_orders.count()))));
+}
+
+int SubtitlesTimeline::pixelAt(qint64 time) const
+{
+	return int(qBound(-1000000.0, ((time - m_viewBegin) / m_scale), 1000000.0));
+}
+
+qint64 SubtitlesTimeline::timeAt(int x) const
+{
+	return (m_viewBegin + qint64(x * m_scale));
+}
+
+qint64 SubtitlesTimeline::duration() const
+{
+	return qMax(m_duration, m_contentDuration);
+}
+
+double SubtitlesTimeline::scale() const
+{
+	return m_scale;
+}
+
+QSize SubtitlesTimeline::sizeHint() const
+{
+	return QSize(600, 100);
+}
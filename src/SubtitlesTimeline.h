@@ -0,0 +1,125 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESTIMELINE_H
+#define SUBTITLESTIMELINE_H
+
+#include "SubtitlesTrack.h"
+#include "WaveformPeaks.h"
+
+#include <QtWidgets/QWidget>
+
+class SubtitlesTimeline : public QWidget
+{
+	Q_OBJECT
+
+public:
+	enum
+	{
+		RulerHeight = 18,
+		HandleWidth = 4,
+		MinimumBlockWidth = 3,
+		BucketWidth = 2,
+		MinimumLength = 100
+	};
+
+	explicit SubtitlesTimeline(QWidget *parent = NULL);
+
+	void setTracks(const QList<SubtitlesTrack> *tracks);
+	void setWaveform(const WaveformPeaks *waveform);
+	qint64 duration() const;
+	double scale() const;
+	QSize sizeHint() const;
+
+public slots:
+	void setDuration(qint64 duration);
+	void setPosition(qint64 position);
+	void setCurrentSubtitle(int track, int subtitle);
+	void tracksChanged();
+	void trackChanged(int track);
+	void subtitlesChanged(int track, int first, int last);
+	void waveformChanged();
+	void zoomIn();
+	void zoomOut();
+	void zoomToFit();
+
+protected:
+	enum DragMode
+	{
+		NoDrag = 0,
+		SeekDrag,
+		MoveDrag,
+		BeginDrag,
+		EndDrag
+	};
+
+	void paintEvent(QPaintEvent *event);
+	void resizeEvent(QResizeEvent *event);
+	void mousePressEvent(QMouseEvent *event);
+	void mouseMoveEvent(QMouseEvent *event);
+	void mouseReleaseEvent(QMouseEvent *event);
+	void wheelEvent(QWheelEvent *event);
+	void ensureOrders();
+	void buildOrder(int track);
+	void moveSubtitle(int track, int subtitle);
+	void updateContentDuration();
+	void contentChanged();
+	void visibleRange(int track, qint64 begin, qint64 end, int *first, int *last) const;
+	void setView(qint64 begin, double scale);
+	DragMode hitTest(const QPoint &point, int *track, int *subtitle) const;
+	QRect trackRect(int track) const;
+	int trackAt(int y) const;
+	int pixelAt(qint64 time) const;
+	qint64 timeAt(int x) const;
+
+private:
+	const QList<SubtitlesTrack> *m_tracks;
+	const WaveformPeaks *m_waveform;
+	QVector<QVector<int> > m_orders;
+	QVector<QVector<qint64> > m_begins;
+	QVector<QVector<qint64> > m_ends;
+	QVector<QVector<qint64> > m_maximumEnds;
+	QVector<bool> m_validOrders;
+	qint64 m_duration;
+	qint64 m_contentDuration;
+	qint64 m_position;
+	qint64 m_viewBegin;
+	double m_scale;
+	int m_currentTrack;
+	int m_currentSubtitle;
+	DragMode m_dragMode;
+	int m_dragTrack;
+	int m_dragSubtitle;
+	qint64 m_dragTime;
+	qint64 m_dragBegin;
+	qint64 m_dragEnd;
+	bool m_ordersValid;
+	bool m_fitted;
+
+signals:
+	void positionRequested(int position);
+	void subtitleSelected(int track, int subtitle);
+	void subtitleRetimed(int track, int subtitle, qint64 begin, qint64 end);
+	void retimeFinished();
+
+};
+
+#endif
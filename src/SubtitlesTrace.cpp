@@ -0,0 +1,205 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+
+#include "SubtitlesTrace.h"
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+struct SubtitlesTraceEvent
+{
+	const char *name;
+	qint64 begin;
+	qint64 duration;
+};
+
+struct SubtitlesTraceBuffer
+{
+	SubtitlesTraceBuffer() : written(0),
+		thread(0)
+	{
+	}
+
+	QVector<SubtitlesTraceEvent> events;
+	QString name;
+	QAtomicInteger<quint64> written;
+	int thread;
+};
+
+bool SubtitlesTrace::m_enabled = false;
+
+static QElapsedTimer traceTimer;
+static QString traceFileName;
+static QMutex traceMutex;
+static QList<SubtitlesTraceBuffer*> traceBuffers;
+static thread_local SubtitlesTraceBuffer *threadBuffer = NULL;
+
+static void appendEscaped(QByteArray *json, const QByteArray &text)
+{
+	for (int i = 0; i < text.size(); ++i)
+	{
+		const char character = text.at(i);
+
+		if (character == '"' || character == '\\')
+		{
+			json->append('\\');
+			json->append(character);
+		}
+		else if (uchar(character) < 0x20)
+		{
+			json->append(' ');
+		}
+		else
+		{
+			json->append(character);
+		}
+	}
+}
+
+static SubtitlesTraceBuffer* createBuffer()
+{
+	SubtitlesTraceBuffer *buffer = new SubtitlesTraceBuffer();
+	buffer->events.resize(SubtitlesTrace::BufferCapacity);
+
+	QThread *thread = QThread::currentThread();
+
+	if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+	{
+		buffer->name = QLatin1String("Main");
+	}
+	else
+	{
+		buffer->name = (thread->objectName().isEmpty() ? QString("Thread %1").arg(quintptr(thread), 0, 16) : thread->objectName());
+	}
+
+	QMutexLocker locker(&traceMutex);
+
+	buffer->thread = (traceBuffers.count() + 1);
+
+	traceBuffers.append(buffer);
+
+	return buffer;
+}
+
+void SubtitlesTrace::enable(const QString &fileName)
+{
+	traceFileName = fileName;
+	traceTimer.start();
+
+	m_enabled = true;
+}
+
+bool SubtitlesTrace::save()
+{
+	if (!m_enabled || traceFileName.isEmpty())
+	{
+		return false;
+	}
+
+	m_enabled = false;
+
+	QThreadPool::globalInstance()->waitForDone();
+
+	QSaveFile file(traceFileName);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	file.write(toJson());
+
+	return file.commit();
+}
+
+QByteArray SubtitlesTrace::toJson()
+{
+	QMutexLocker locker(&traceMutex);
+	const QByteArray process = QByteArray::number(QCoreApplication::applicationPid());
+	QByteArray json("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	bool first = true;
+
+	for (int i = 0; i < traceBuffers.count(); ++i)
+	{
+		const SubtitlesTraceBuffer *buffer = traceBuffers.at(i);
+		const QByteArray thread = QByteArray::number(buffer->thread);
+		const quint64 written = buffer->written.loadAcquire();
+		const quint64 count = qMin(written, quint64(BufferCapacity));
+
+		json.append(first ? "" : ",");
+		json.append("\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + process + ",\"tid\":" + thread + ",\"args\":{\"name\":\"");
+
+		appendEscaped(&json, buffer->name.toUtf8());
+
+		json.append("\"}}");
+
+		first = false;
+
+		for (quint64 j = (written - count); j < written; ++j)
+		{
+			const SubtitlesTraceEvent &event = buffer->events.at(int(j % BufferCapacity));
+
+			json.append(",\n{\"name\":\"");
+
+			appendEscaped(&json, QByteArray(event.name));
+
+			json.append("\",\"cat\":\"subtitles\",\"ph\":\"X\",\"ts\":" + QByteArray::number(event.begin) + ",\"dur\":" + QByteArray::number(event.duration) + ",\"pid\":" + process + ",\"tid\":" + thread + "}");
+		}
+	}
+
+	json.append("\n]}\n");
+
+	return json;
+}
+
+qint64 SubtitlesTrace::timestamp()
+{
+	return (traceTimer.nsecsElapsed() / 1000);
+}
+
+void SubtitlesTrace::record(const char *name, qint64 begin, qint64 end)
+{
+	if (!threadBuffer)
+	{
+		threadBuffer = createBuffer();
+	}
+
+	const quint64 written = threadBuffer->written.load();
+	SubtitlesTraceEvent &event = threadBuffer->events[int(written % BufferCapacity)];
+	event.name = name;
+	event.begin = begin;
+	event.duration = (end - begin);
+
+	threadBuffer->written.storeRelease(written + 1);
+}
+
+QString SubtitlesTrace::fileName()
+{
+	return traceFileName;
+}
@@ -0,0 +1,85 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+
+#ifndef SUBTITLESTRACE_H
+#define SUBTITLESTRACE_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+class SubtitlesTrace
+{
+public:
+	enum
+	{
+		BufferCapacity = 65536
+	};
+
+	static void enable(const QString &fileName);
+	static bool save();
+	static QByteArray toJson();
+	static qint64 timestamp();
+	static void record(const char *name, qint64 begin, qint64 end);
+	static QString fileName();
+
+	static inline bool isEnabled()
+	{
+		return m_enabled;
+	}
+
+private:
+	static bool m_enabled;
+};
+
+class SubtitlesTraceSpan
+{
+public:
+	explicit inline SubtitlesTraceSpan(const char *name) : m_name(SubtitlesTrace::isEnabled() ? name : NULL),
+		m_begin(m_name ? SubtitlesTrace::timestamp() : 0)
+	{
+	}
+
+	inline ~SubtitlesTraceSpan()
+	{
+		if (m_name)
+		{
+			SubtitlesTrace::record(m_name, m_begin, SubtitlesTrace::timestamp());
+		}
+	}
+
+private:
+	Q_DISABLE_COPY(SubtitlesTraceSpan)
+
+	const char *m_name;
+	qint64 m_begin;
+};
+
+#define SUBTITLES_TRACE_JOIN(a, b) a##b
+#define SUBTITLES_TRACE_VARIABLE(line) SUBTITLES_TRACE_JOIN(traceSpan, line)
+
+#ifdef SUBTITLES_NO_TRACE
+#define SUBTITLES_TRACE(name)
+#else
+#define SUBTITLES_TRACE(name) const SubtitlesTraceSpan SUBTITLES_TRACE_VARIABLE(__LINE__)(name)
+#endif
+
+#endif
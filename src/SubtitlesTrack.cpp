@@ -0,0 +1,357 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesTrack.h"
+#include "SubtitlesRetimer.h"
+
+SubtitlesTrack::SubtitlesTrack() : m_indexValid(true),
+	m_modified(false)
+{
+}
+
+void SubtitlesTrack::clear()
+{
+	m_begins.clear();
+	m_ends.clear();
+	m_positions.clear();
+	m_texts.clear();
+	m_modifiedSubtitles.clear();
+	m_index.clear();
+
+	m_indexValid = true;
+	m_modified = false;
+}
+
+void SubtitlesTrack::reserve(int size)
+{
+	m_begins.reserve(size);
+	m_ends.reserve(size);
+	m_positions.reserve(size);
+	m_texts.reserve(size);
+	m_modifiedSubtitles.reserve(size);
+}
+
+void SubtitlesTrack::append(const Subtitle &subtitle)
+{
+	m_begins.append(subtitle.begin);
+	m_ends.append(subtitle.end);
+	m_positions.append(subtitle.position);
+	m_texts.append(subtitle.text);
+	m_modifiedSubtitles.append(false);
+
+	m_indexValid = false;
+}
+
+void SubtitlesTrack::insert(int subtitle, const Subtitle &data)
+{
+	m_begins.insert(subtitle, data.begin);
+	m_ends.insert(subtitle, data.end);
+	m_positions.insert(subtitle, data.position);
+	m_texts.insert(subtitle, data.text);
+	m_modifiedSubtitles.insert(subtitle, true);
+
+	m_modified = true;
+
+	if (m_indexValid)
+	{
+		m_index.insert(subtitle, data.begin, data.end);
+	}
+}
+
+void SubtitlesTrack::remove(int subtitle)
+{
+	if (subtitle < 0 || subtitle >= count())
+	{
+		return;
+	}
+
+	m_begins.remove(subtitle);
+	m_ends.remove(subtitle);
+	m_positions.remove(subtitle);
+	m_texts.remove(subtitle);
+	m_modifiedSubtitles.remove(subtitle);
+
+	m_modified = true;
+
+	if (m_indexValid)
+	{
+		m_index.remove(subtitle);
+	}
+}
+
+void SubtitlesTrack::setSubtitle(int subtitle, const Subtitle &data)
+{
+	setText(subtitle, data.text);
+	setPosition(subtitle, data.position);
+	setTimes(subtitle, data.begin, data.end);
+}
+
+void SubtitlesTrack::setText(int subtitle, const QString &text)
+{
+	if (m_texts.at(subtitle) != text)
+	{
+		m_texts[subtitle] = text;
+		m_modifiedSubtitles[subtitle] = true;
+
+		m_modified = true;
+
+		m_index.invalidate();
+	}
+}
+
+void SubtitlesTrack::setTimes(int subtitle, qint64 begin, qint64 end)
+{
+	if (m_begins.at(subtitle) == begin && m_ends.at(subtitle) == end)
+	{
+		return;
+	}
+
+	m_begins[subtitle] = begin;
+	m_ends[subtitle] = end;
+	m_modifiedSubtitles[subtitle] = true;
+
+	m_modified = true;
+
+	if (m_indexValid)
+	{
+		m_index.update(subtitle, begin, end);
+	}
+}
+
+void SubtitlesTrack::setTimes(const QVector<qint64> &begins, const QVector<qint64> &ends)
+{
+	if (begins.count() != count() || ends.count() != count())
+	{
+		return;
+	}
+
+	for (int i = 0; i < count(); ++i)
+	{
+		if (m_begins.at(i) != begins.at(i) || m_ends.at(i) != ends.at(i))
+		{
+			m_modifiedSubtitles[i] = true;
+
+			m_modified = true;
+		}
+	}
+
+	m_begins = begins;
+	m_ends = ends;
+	m_indexValid = false;
+}
+
+void SubtitlesTrack::setPosition(int subtitle, const QPoint &position)
+{
+	if (m_positions.at(subtitle) != position)
+	{
+		m_positions[subtitle] = position;
+		m_modifiedSubtitles[subtitle] = true;
+
+		m_modified = true;
+	}
+}
+
+void SubtitlesTrack::transform(double scale, double offset)
+{
+	const SubtitlesRetimer retimer(scale, offset);
+	const int size = count();
+
+	retimer.apply(m_begins.data(), size);
+	retimer.apply(m_ends.data(), size);
+
+	if (size > 0 && (scale != 1 || offset != 0))
+	{
+		m_modifiedSubtitles.fill(true);
+
+		m_modified = true;
+	}
+
+	if (m_indexValid)
+	{
+		m_index.transform(scale, offset);
+	}
+}
+
+void SubtitlesTrack::transform(double scale, double offset, int first, int last)
+{
+	first = qMax(0, first);
+	last = qMin(last, (count() - 1));
+
+	if (first > last)
+	{
+		return;
+	}
+
+	if (first == 0 && last == (count() - 1))
+	{
+		transform(scale, offset);
+
+		return;
+	}
+
+	const SubtitlesRetimer retimer(scale, offset);
+	const int size = ((last - first) + 1);
+
+	retimer.apply((m_begins.data() + first), size);
+	retimer.apply((m_ends.data() + first), size);
+
+	if (scale != 1 || offset != 0)
+	{
+		for (int i = first; i <= last; ++i)
+		{
+			m_modifiedSubtitles[i] = true;
+		}
+
+		m_modified = true;
+	}
+
+	m_indexValid = false;
+}
+
+void SubtitlesTrack::setModified(bool modified)
+{
+	if (!modified)
+	{
+		m_modifiedSubtitles.fill(false);
+	}
+
+	m_modified = modified;
+}
+
+void SubtitlesTrack::setModified(int subtitle, bool modified)
+{
+	m_modifiedSubtitles[subtitle] = modified;
+
+	if (modified)
+	{
+		m_modified = true;
+	}
+}
+
+void SubtitlesTrack::invalidate()
+{
+	m_index.invalidate();
+}
+
+bool SubtitlesTrack::seek(qint64 time)
+{
+	ensureIndex();
+
+	return m_index.seek(time);
+}
+
+QVector<int> SubtitlesTrack::activeSubtitles() const
+{
+	return m_index.activeSubtitles();
+}
+
+Subtitle SubtitlesTrack::subtitle(int subtitle) const
+{
+	Subtitle data;
+	data.text = m_texts.at(subtitle);
+	data.begin = m_begins.at(subtitle);
+	data.end = m_ends.at(subtitle);
+	data.position = m_positions.at(subtitle);
+
+	return data;
+}
+
+QString SubtitlesTrack::text(int subtitle) const
+{
+	return m_texts.at(subtitle);
+}
+
+QPoint SubtitlesTrack::position(int subtitle) const
+{
+	return m_positions.at(subtitle);
+}
+
+qint64 SubtitlesTrack::begin(int subtitle) const
+{
+	return m_begins.at(subtitle);
+}
+
+qint64 SubtitlesTrack::end(int subtitle) const
+{
+	return m_ends.at(subtitle);
+}
+
+QVector<qint64> SubtitlesTrack::beginTimes() const
+{
+	return m_begins;
+}
+
+QVector<qint64> SubtitlesTrack::endTimes() const
+{
+	return m_ends;
+}
+
+const qint64* SubtitlesTrack::begins() const
+{
+	return m_begins.constData();
+}
+
+const qint64* SubtitlesTrack::ends() const
+{
+	return m_ends.constData();
+}
+
+qint64 SubtitlesTrack::memoryUsage() const
+{
+	qint64 usage = (qint64(count()) * ((2 * sizeof(qint64)) + sizeof(QPoint) + sizeof(QString) + sizeof(bool)));
+
+	for (int i = 0; i < m_texts.count(); ++i)
+	{
+		usage += (m_texts.at(i).size() * sizeof(QChar));
+	}
+
+	return usage;
+}
+
+int SubtitlesTrack::count() const
+{
+	return m_begins.count();
+}
+
+bool SubtitlesTrack::isEmpty() const
+{
+	return m_begins.isEmpty();
+}
+
+bool SubtitlesTrack::isModified() const
+{
+	return m_modified;
+}
+
+bool SubtitlesTrack::isModified(int subtitle) const
+{
+	return m_modifiedSubtitles.at(subtitle);
+}
+
+void SubtitlesTrack::ensureIndex()
+{
+	if (!m_indexValid)
+	{
+		m_index.rebuild(m_begins.constData(), m_ends.constData(), count());
+
+		m_indexValid = true;
+	}
+}
@@ -0,0 +1,81 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESTRACK_H
+#define SUBTITLESTRACK_H
+
+#include "Subtitle.h"
+#include "SubtitlesIndex.h"
+
+#include <QtCore/QVector>
+
+class SubtitlesTrack
+{
+public:
+	SubtitlesTrack();
+
+	void clear();
+	void reserve(int size);
+	void append(const Subtitle &subtitle);
+	void insert(int subtitle, const Subtitle &data);
+	void remove(int subtitle);
+	void setSubtitle(int subtitle, const Subtitle &data);
+	void setText(int subtitle, const QString &text);
+	void setTimes(int subtitle, qint64 begin, qint64 end);
+	void setTimes(const QVector<qint64> &begins, const QVector<qint64> &ends);
+	void setPosition(int subtitle, const QPoint &position);
+	void transform(double scale, double offset = 0);
+	void transform(double scale, double offset, int first, int last);
+	void setModified(bool modified);
+	void setModified(int subtitle, bool modified);
+	void invalidate();
+	bool seek(qint64 time);
+	QVector<int> activeSubtitles() const;
+	Subtitle subtitle(int subtitle) const;
+	QString text(int subtitle) const;
+	QPoint position(int subtitle) const;
+	qint64 begin(int subtitle) const;
+	qint64 end(int subtitle) const;
+	QVector<qint64> beginTimes() const;
+	QVector<qint64> endTimes() const;
+	const qint64* begins() const;
+	const qint64* ends() const;
+	qint64 memoryUsage() const;
+	int count() const;
+	bool isEmpty() const;
+	bool isModified() const;
+	bool isModified(int subtitle) const;
+
+protected:
+	void ensureIndex();
+
+private:
+	QVector<qint64> m_begins;
+	QVector<qint64> m_ends;
+	QVector<QPoint> m_positions;
+	QVector<QString> m_texts;
+	QVector<bool> m_modifiedSubtitles;
+	SubtitlesIndex m_index;
+	bool m_indexValid;
+	bool m_modified;
+};
+
+#endif
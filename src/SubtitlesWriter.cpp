@@ -0,0 +1,218 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "SubtitlesWriter.h"
+#include "SubtitlesTrace.h"
+
+#include <QtCore/QSaveFile>
+
+SubtitlesWriter::SubtitlesWriter()
+{
+}
+
+bool SubtitlesWriter::writeFile(const QString &fileName, const SubtitlesTrack &track)
+{
+	QSaveFile file(fileName);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+	{
+		m_errorString = file.errorString();
+
+		return false;
+	}
+
+	const QByteArray data = format(track);
+
+	if (file.write(data) != data.size() || !file.commit())
+	{
+		m_errorString = file.errorString();
+
+		return false;
+	}
+
+	m_errorString.clear();
+
+	return true;
+}
+
+QByteArray SubtitlesWriter::format(const SubtitlesTrack &track)
+{
+	SUBTITLES_TRACE("SubtitlesWriter::format");
+
+	const int count = track.count();
+	const qint64 *begins = track.begins();
+	const qint64 *ends = track.ends();
+	int capacity = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		capacity += (96 + (track.text(i).length() * 3));
+	}
+
+	m_buffer.resize(capacity);
+
+	char *data = m_buffer.data();
+	int length = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		const QPoint position = track.position(i);
+
+		length += formatNumber(position.x(), (data + length));
+		data[length++] = '\t';
+		length += formatNumber(position.y(), (data + length));
+		data[length++] = '\t';
+		data[length++] = '\t';
+		length += formatTime(begins[i], (data + length));
+		data[length++] = '\t';
+		length += formatTime(ends[i], (data + length));
+		data[length++] = '\t';
+		data[length++] = '_';
+		data[length++] = '(';
+		data[length++] = '"';
+		length += formatText(track.text(i), (data + length));
+		data[length++] = '"';
+		data[length++] = ')';
+		data[length++] = '\n';
+
+		if ((i + 1) < count && begins[i] != begins[i + 1])
+		{
+			data[length++] = '\n';
+		}
+	}
+
+	m_buffer.resize(length);
+
+	return m_buffer;
+}
+
+QString SubtitlesWriter::errorString() const
+{
+	return m_errorString;
+}
+
+int SubtitlesWriter::formatTime(qint64 time, char *buffer, bool readable)
+{
+	const qint64 fractions = (time / 100);
+	qint64 seconds = (fractions / 10);
+	int length = 0;
+
+	if (readable)
+	{
+		const qint64 minutes = (seconds / 60);
+
+		seconds -= (minutes * 60);
+
+		if (minutes < 10)
+		{
+			buffer[length++] = '0';
+		}
+
+		length += formatNumber(minutes, (buffer + length));
+
+		buffer[length++] = ':';
+
+		if (seconds < 10)
+		{
+			buffer[length++] = '0';
+		}
+	}
+
+	length += formatNumber(seconds, (buffer + length));
+
+	buffer[length++] = '.';
+
+	length += formatNumber((fractions % 10), (buffer + length));
+
+	return length;
+}
+
+int SubtitlesWriter::formatNumber(qint64 number, char *buffer)
+{
+	char digits[20];
+	int count = 0;
+	int length = 0;
+	quint64 value = ((number < 0) ? -number : number);
+
+	if (number < 0)
+	{
+		buffer[length++] = '-';
+	}
+
+	do
+	{
+		digits[count++] = ('0' + (value % 10));
+
+		value /= 10;
+	}
+	while (value > 0);
+
+	while (count > 0)
+	{
+		buffer[length++] = digits[--count];
+	}
+
+	return length;
+}
+
+int SubtitlesWriter::formatText(const QString &text, char *buffer)
+{
+	const ushort *characters = text.utf16();
+	const int size = text.length();
+	int length = 0;
+
+	for (int i = 0; i < size; ++i)
+	{
+		uint character = characters[i];
+
+		if (character >= 0xD800 && character < 0xDC00 && (i + 1) < size && characters[i + 1] >= 0xDC00 && characters[i + 1] < 0xE000)
+		{
+			character = (0x10000 + ((character - 0xD800) << 10) + (characters[i + 1] - 0xDC00));
+
+			++i;
+		}
+
+		if (character < 0x80)
+		{
+			buffer[length++] = character;
+		}
+		else if (character < 0x800)
+		{
+			buffer[length++] = (0xC0 | (character >> 6));
+			buffer[length++] = (0x80 | (character & 0x3F));
+		}
+		else if (character < 0x10000)
+		{
+			buffer[length++] = (0xE0 | (character >> 12));
+			buffer[length++] = (0x80 | ((character >> 6) & 0x3F));
+			buffer[length++] = (0x80 | (character & 0x3F));
+		}
+		else
+		{
+			buffer[length++] = (0xF0 | (character >> 18));
+			buffer[length++] = (0x80 | ((character >> 12) & 0x3F));
+			buffer[length++] = (0x80 | ((character >> 6) & 0x3F));
+			buffer[length++] = (0x80 | (character & 0x3F));
+		}
+	}
+
+	return length;
+}
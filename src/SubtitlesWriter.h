@@ -0,0 +1,48 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef SUBTITLESWRITER_H
+#define SUBTITLESWRITER_H
+
+#include "SubtitlesTrack.h"
+
+#include <QtCore/QByteArray>
+
+class SubtitlesWriter
+{
+public:
+	SubtitlesWriter();
+
+	bool writeFile(const QString &fileName, const SubtitlesTrack &track);
+	QByteArray format(const SubtitlesTrack &track);
+	QString errorString() const;
+	static int formatTime(qint64 time, char *buffer, bool readable = false);
+
+protected:
+	static int formatNumber(qint64 number, char *buffer);
+	static int formatText(const QString &text, char *buffer);
+
+private:
+	QByteArray m_buffer;
+	QString m_errorString;
+};
+
+#endif
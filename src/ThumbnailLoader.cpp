@@ -0,0 +1,335 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+
+#include "ThumbnailLoader.h"
+#include "WaveformPeaks.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+#include <QtMultimedia/QAbstractVideoSurface>
+#include <QtMultimedia/QMediaPlayer>
+
+static const quint32 thumbnailsMagic = 0x57544E42;
+static const quint32 thumbnailsVersion = 1;
+
+class ThumbnailSurface : public QAbstractVideoSurface
+{
+public:
+	explicit ThumbnailSurface(ThumbnailLoader *loader) : QAbstractVideoSurface(loader),
+		m_loader(loader)
+	{
+	}
+
+	void setGeneration(int generation)
+	{
+		m_generation.storeRelease(generation);
+	}
+
+	QList<QVideoFrame::PixelFormat> supportedPixelFormats(QAbstractVideoBuffer::HandleType type) const
+	{
+		QList<QVideoFrame::PixelFormat> formats;
+
+		if (type == QAbstractVideoBuffer::NoHandle)
+		{
+			formats << QVideoFrame::Format_RGB32 << QVideoFrame::Format_ARGB32 << QVideoFrame::Format_ARGB32_Premultiplied << QVideoFrame::Format_RGB24 << QVideoFrame::Format_RGB565;
+		}
+
+		return formats;
+	}
+
+	bool present(const QVideoFrame &frame)
+	{
+		const int generation = m_generation.loadAcquire();
+		const qint64 position = ((frame.startTime() >= 0) ? (frame.startTime() / 1000) : -1);
+		QVideoFrame mappedFrame(frame);
+		const QImage::Format format = QVideoFrame::imageFormatFromPixelFormat(mappedFrame.pixelFormat());
+
+		if (format == QImage::Format_Invalid || !mappedFrame.map(QAbstractVideoBuffer::ReadOnly))
+		{
+			return true;
+		}
+
+		const QImage image = QImage(mappedFrame.bits(), mappedFrame.width(), mappedFrame.height(), mappedFrame.bytesPerLine(), format).scaledToHeight(ThumbnailLoader::ThumbnailHeight, Qt::SmoothTransformation).convertToFormat(QImage::Format_RGB32);
+
+		mappedFrame.unmap();
+
+		QMetaObject::invokeMethod(m_loader, "frameCaptured", Qt::QueuedConnection, Q_ARG(QImage, image), Q_ARG(int, generation), Q_ARG(qint64, position));
+
+		return true;
+	}
+
+private:
+	ThumbnailLoader *m_loader;
+	QAtomicInt m_generation;
+};
+
+ThumbnailLoader::ThumbnailLoader(QObject *parent) : QObject(parent),
+	m_player(new QMediaPlayer(this, QMediaPlayer::VideoSurface)),
+	m_surface(new ThumbnailSurface(this)),
+	m_timer(new QTimer(this)),
+	m_interval(0),
+	m_next(0),
+	m_generation(0),
+	m_notifiedThumbnails(0)
+{
+	m_player->setMuted(true);
+	m_player->setVideoOutput(m_surface);
+
+	m_timer->setSingleShot(true);
+
+	connect(m_player, SIGNAL(durationChanged(qint64)), this, SLOT(durationChanged(qint64)));
+	connect(m_player, SIGNAL(error(QMediaPlayer::Error)), this, SLOT(cancel()));
+	connect(m_timer, SIGNAL(timeout()), this, SLOT(timeout()));
+}
+
+void ThumbnailLoader::load(const QString &fileName)
+{
+	cancel();
+
+	m_thumbnails.clear();
+	m_fileName = fileName;
+	m_cachePath = cachePath(fileName);
+	m_interval = 0;
+	m_next = 0;
+	m_notifiedThumbnails = 0;
+
+	if (!m_cachePath.isEmpty() && loadCache())
+	{
+		emit thumbnailsChanged();
+
+		return;
+	}
+
+	m_thumbnails.clear();
+	m_interval = 0;
+
+	m_player->setMedia(QUrl::fromLocalFile(fileName));
+	m_player->pause();
+
+	emit thumbnailsChanged();
+}
+
+void ThumbnailLoader::cancel()
+{
+	m_timer->stop();
+
+	if (!m_player->media().isNull())
+	{
+		m_player->stop();
+		m_player->setMedia(QMediaContent());
+	}
+}
+
+bool ThumbnailLoader::loadCache()
+{
+	QFile file(m_cachePath);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic = 0;
+	quint32 version = 0;
+	qint64 interval = 0;
+	QVector<QImage> thumbnails;
+
+	stream >> magic >> version >> interval >> thumbnails;
+
+	if (stream.status() != QDataStream::Ok || magic != thumbnailsMagic || version != thumbnailsVersion || interval <= 0 || thumbnails.isEmpty())
+	{
+		return false;
+	}
+
+	m_interval = interval;
+	m_thumbnails = thumbnails;
+
+	return true;
+}
+
+bool ThumbnailLoader::saveCache() const
+{
+	QDir().mkpath(QFileInfo(m_cachePath).absolutePath());
+
+	QSaveFile file(m_cachePath);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << thumbnailsMagic << thumbnailsVersion << m_interval << m_thumbnails;
+
+	return file.commit();
+}
+
+void ThumbnailLoader::requestNext()
+{
+	if (m_next >= m_thumbnails.count())
+	{
+		finish();
+
+		return;
+	}
+
+	++m_generation;
+
+	m_surface->setGeneration(m_generation);
+	m_player->setPosition(m_next * m_interval);
+
+	m_timer->start(FrameTimeout);
+}
+
+void ThumbnailLoader::finish()
+{
+	cancel();
+
+	if (!m_cachePath.isEmpty())
+	{
+		saveCache();
+	}
+
+	emit thumbnailsChanged();
+}
+
+void ThumbnailLoader::durationChanged(qint64 duration)
+{
+	if (duration <= 0 || !m_thumbnails.isEmpty() || !isLoading())
+	{
+		return;
+	}
+
+	m_interval = qMax(qint64(MinimumInterval), ((duration + MaximumThumbnails - 1) / MaximumThumbnails));
+	m_thumbnails.resize(int(duration / m_interval) + 1);
+	m_next = 0;
+
+	requestNext();
+}
+
+void ThumbnailLoader::frameCaptured(const QImage &image, int generation, qint64 position)
+{
+	if (generation != m_generation || !m_timer->isActive() || image.isNull() || m_next >= m_thumbnails.count())
+	{
+		return;
+	}
+
+	if (position >= 0 && qAbs(position - (m_next * m_interval)) > (m_interval / 2))
+	{
+		return;
+	}
+
+	m_timer->stop();
+
+	m_thumbnails[m_next] = image;
+
+	++m_next;
+
+	if ((m_next - m_notifiedThumbnails) >= 16)
+	{
+		m_notifiedThumbnails = m_next;
+
+		emit thumbnailsChanged();
+	}
+
+	requestNext();
+}
+
+void ThumbnailLoader::timeout()
+{
+	if (!m_player->isVideoAvailable())
+	{
+		cancel();
+
+		m_thumbnails.clear();
+
+		emit thumbnailsChanged();
+
+		return;
+	}
+
+	++m_next;
+
+	requestNext();
+}
+
+QImage ThumbnailLoader::thumbnail(qint64 position) const
+{
+	if (m_thumbnails.isEmpty() || m_interval <= 0)
+	{
+		return QImage();
+	}
+
+	const int index = qBound(0, int((position + (m_interval / 2)) / m_interval), (m_thumbnails.count() - 1));
+
+	for (int offset = 0; offset < m_thumbnails.count(); ++offset)
+	{
+		if (index >= offset && !m_thumbnails.at(index - offset).isNull())
+		{
+			return m_thumbnails.at(index - offset);
+		}
+
+		if ((index + offset) < m_thumbnails.count() && !m_thumbnails.at(index + offset).isNull())
+		{
+			return m_thumbnails.at(index + offset);
+		}
+	}
+
+	return QImage();
+}
+
+QString ThumbnailLoader::fileName() const
+{
+	return m_fileName;
+}
+
+qint64 ThumbnailLoader::interval() const
+{
+	return m_interval;
+}
+
+int ThumbnailLoader::count() const
+{
+	return m_thumbnails.count();
+}
+
+bool ThumbnailLoader::isLoading() const
+{
+	return !m_player->media().isNull();
+}
+
+QString ThumbnailLoader::cachePath(const QString &mediaFile)
+{
+	const QString key = WaveformPeaks::cacheKey(mediaFile);
+
+	return (key.isEmpty() ? QString() : (QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QString("/thumbnails/%1.dat").arg(key)));
+}
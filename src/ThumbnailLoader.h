@@ -0,0 +1,88 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+
+#ifndef THUMBNAILLOADER_H
+#define THUMBNAILLOADER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtGui/QImage>
+
+class QMediaPlayer;
+class QTimer;
+class ThumbnailSurface;
+
+class ThumbnailLoader : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum
+	{
+		ThumbnailHeight = 72,
+		MaximumThumbnails = 240,
+		MinimumInterval = 2000,
+		FrameTimeout = 1500
+	};
+
+	explicit ThumbnailLoader(QObject *parent = NULL);
+
+	void load(const QString &fileName);
+	QImage thumbnail(qint64 position) const;
+	QString fileName() const;
+	qint64 interval() const;
+	int count() const;
+	bool isLoading() const;
+	static QString cachePath(const QString &mediaFile);
+
+public slots:
+	void cancel();
+
+protected:
+	bool loadCache();
+	bool saveCache() const;
+	void requestNext();
+	void finish();
+
+protected slots:
+	void durationChanged(qint64 duration);
+	void frameCaptured(const QImage &image, int generation, qint64 position);
+	void timeout();
+
+private:
+	QMediaPlayer *m_player;
+	ThumbnailSurface *m_surface;
+	QTimer *m_timer;
+	QVector<QImage> m_thumbnails;
+	QString m_fileName;
+	QString m_cachePath;
+	qint64 m_interval;
+	int m_next;
+	int m_generation;
+	int m_notifiedThumbnails;
+
+signals:
+	void thumbnailsChanged();
+
+};
+
+#endif
@@ -0,0 +1,94 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "TimeSpinBox.h"
+
+#include <QtCore/QRegularExpression>
+
+#include <limits>
+
+static const QRegularExpression timeExpression("^(\\d{1,6}):([0-5]?\\d)(?:\\.(\\d{0,3}))?$");
+
+TimeSpinBox::TimeSpinBox(QWidget *parent) : QSpinBox(parent)
+{
+	setRange(0, std::numeric_limits<int>::max());
+	setSingleStep(100);
+	setAccelerated(true);
+}
+
+void TimeSpinBox::setTime(qint64 time)
+{
+	setValue(static_cast<int>(qBound(qint64(minimum()), time, qint64(maximum()))));
+}
+
+qint64 TimeSpinBox::time() const
+{
+	return value();
+}
+
+QString TimeSpinBox::textFromValue(int value) const
+{
+	const qint64 time = qMax(0, value);
+
+	return QString("%1:%2.%3").arg((time / 60000), 2, 10, QLatin1Char('0')).arg(((time / 1000) % 60), 2, 10, QLatin1Char('0')).arg((time % 1000), 3, 10, QLatin1Char('0'));
+}
+
+int TimeSpinBox::valueFromText(const QString &text) const
+{
+	int value = 0;
+
+	return (parseTime(text, &value) ? value : this->value());
+}
+
+QValidator::State TimeSpinBox::validate(QString &input, int &position) const
+{
+	Q_UNUSED(position)
+
+	int value = 0;
+
+	if (parseTime(input, &value))
+	{
+		return ((value >= minimum() && value <= maximum()) ? QValidator::Acceptable : QValidator::Intermediate);
+	}
+
+	return (timeExpression.match(input.trimmed(), 0, QRegularExpression::PartialPreferCompleteMatch).hasPartialMatch() ? QValidator::Intermediate : QValidator::Invalid);
+}
+
+bool TimeSpinBox::parseTime(const QString &text, int *value) const
+{
+	const QRegularExpressionMatch match = timeExpression.match(text.trimmed());
+
+	if (!match.hasMatch())
+	{
+		return false;
+	}
+
+	const qint64 time = ((((match.captured(1).toLongLong() * 60) + match.captured(2).toLongLong()) * 1000) + match.captured(3).leftJustified(3, QLatin1Char('0')).toLongLong());
+
+	if (time > std::numeric_limits<int>::max())
+	{
+		return false;
+	}
+
+	*value = static_cast<int>(time);
+
+	return true;
+}
@@ -0,0 +1,331 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "WaveformLoader.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+static void extractFeatures(SpeechDetector *detector, const QVector<qint16> &samples, int channels)
+{
+	detector->appendSamples(samples.constData(), (samples.count() / channels), channels);
+}
+
+WaveformLoader::WaveformLoader(QObject *parent) : QObject(parent),
+	m_decoder(NULL),
+	m_featuresWatcher(NULL),
+	m_speechWatcher(NULL),
+	m_pendingChannels(0),
+	m_notifiedPeaks(0),
+	m_decodingFinished(false)
+{
+}
+
+void WaveformLoader::load(const QString &fileName)
+{
+	cancel();
+
+	m_peaks.clear();
+	m_speech.clear();
+	m_speechSegments.clear();
+	m_fileName = fileName;
+	m_cachePath = WaveformPeaks::cachePath(fileName);
+	m_speechCachePath = SpeechDetector::cachePath(fileName);
+	m_notifiedPeaks = 0;
+	m_decodingFinished = false;
+
+	if (!m_cachePath.isEmpty() && m_peaks.load(m_cachePath) && m_speech.load(m_speechCachePath))
+	{
+		emit peaksChanged();
+
+		startDetection();
+
+		return;
+	}
+
+	m_peaks.clear();
+	m_speech.clear();
+
+	QAudioFormat format;
+	format.setCodec("audio/pcm");
+	format.setByteOrder(QAudioFormat::LittleEndian);
+	format.setSampleType(QAudioFormat::SignedInt);
+	format.setSampleSize(16);
+	format.setSampleRate(SampleRate);
+	format.setChannelCount(1);
+
+	m_decoder = new QAudioDecoder(this);
+	m_decoder->setSourceFilename(fileName);
+	m_decoder->setAudioFormat(format);
+
+	connect(m_decoder, SIGNAL(bufferReady()), this, SLOT(bufferReady()));
+	connect(m_decoder, SIGNAL(finished()), this, SLOT(decodingFinished()));
+	connect(m_decoder, SIGNAL(error(QAudioDecoder::Error)), this, SLOT(decodingFailed(QAudioDecoder::Error)));
+
+	m_decoder->start();
+
+	emit peaksChanged();
+	emit speechDetected();
+}
+
+void WaveformLoader::cancel()
+{
+	if (m_decoder)
+	{
+		m_decoder->disconnect(this);
+		m_decoder->stop();
+		m_decoder->deleteLater();
+		m_decoder = NULL;
+	}
+
+	if (m_featuresWatcher)
+	{
+		m_featuresWatcher->disconnect(this);
+		m_featuresWatcher->waitForFinished();
+		m_featuresWatcher->deleteLater();
+		m_featuresWatcher = NULL;
+	}
+
+	m_pendingSamples.clear();
+	m_pendingChannels = 0;
+
+	if (m_speechWatcher)
+	{
+		m_speechWatcher->disconnect(this);
+		m_speechWatcher->deleteLater();
+		m_speechWatcher = NULL;
+	}
+}
+
+void WaveformLoader::startExtraction()
+{
+	QVector<qint16> samples;
+	samples.swap(m_pendingSamples);
+
+	m_featuresWatcher = new QFutureWatcher<void>(this);
+
+	connect(m_featuresWatcher, SIGNAL(finished()), this, SLOT(extractionFinished()));
+
+	m_featuresWatcher->setFuture(QtConcurrent::run(extractFeatures, &m_speech, samples, m_pendingChannels));
+}
+
+void WaveformLoader::finishLoading()
+{
+	m_speech.finish();
+
+	if (!m_peaks.isEmpty() && !m_cachePath.isEmpty())
+	{
+		m_peaks.save(m_cachePath);
+		m_speech.save(m_speechCachePath);
+	}
+
+	cancel();
+
+	emit peaksChanged();
+
+	startDetection();
+}
+
+void WaveformLoader::startDetection()
+{
+	m_speechWatcher = new QFutureWatcher<QVector<SpeechSegment> >(this);
+
+	connect(m_speechWatcher, SIGNAL(finished()), this, SLOT(detectionFinished()));
+
+	m_speechWatcher->setFuture(QtConcurrent::run(m_speech, &SpeechDetector::detect));
+}
+
+void WaveformLoader::bufferReady()
+{
+	const QAudioBuffer buffer = m_decoder->read();
+	const QAudioFormat format = buffer.format();
+
+	if (!buffer.isValid() || format.channelCount() <= 0)
+	{
+		return;
+	}
+
+	const qint16 *samples = buffer.constData<qint16>();
+	const int count = (buffer.frameCount() * format.channelCount());
+
+	if (format.sampleSize() != 16 || format.sampleType() != QAudioFormat::SignedInt)
+	{
+		m_samples.resize(count);
+
+		if (format.sampleType() == QAudioFormat::Float && format.sampleSize() == 32)
+		{
+			const float *data = buffer.constData<float>();
+
+			for (int i = 0; i < count; ++i)
+			{
+				m_samples[i] = qint16(qBound(-32768.0f, (data[i] * 32767.0f), 32767.0f));
+			}
+		}
+		else if (format.sampleType() == QAudioFormat::SignedInt && format.sampleSize() == 32)
+		{
+			const qint32 *data = buffer.constData<qint32>();
+
+			for (int i = 0; i < count; ++i)
+			{
+				m_samples[i] = qint16(data[i] >> 16);
+			}
+		}
+		else if (format.sampleType() == QAudioFormat::UnSignedInt && format.sampleSize() == 8)
+		{
+			const quint8 *data = buffer.constData<quint8>();
+
+			for (int i = 0; i < count; ++i)
+			{
+				m_samples[i] = qint16((int(data[i]) - 128) << 8);
+			}
+		}
+		else
+		{
+			return;
+		}
+
+		samples = m_samples.constData();
+	}
+
+	if (m_peaks.sampleRate() != format.sampleRate())
+	{
+		m_peaks.setSampleRate(format.sampleRate());
+
+		if (!m_featuresWatcher && m_speech.isEmpty())
+		{
+			m_speech.setSampleRate(format.sampleRate());
+		}
+	}
+
+	m_peaks.appendSamples(samples, buffer.frameCount(), format.channelCount());
+
+	if (m_pendingChannels != format.channelCount())
+	{
+		if (!m_pendingSamples.isEmpty())
+		{
+			return;
+		}
+
+		m_pendingChannels = format.channelCount();
+	}
+
+	const int offset = m_pendingSamples.count();
+
+	m_pendingSamples.resize(offset + count);
+
+	std::copy(samples, (samples + count), (m_pendingSamples.begin() + offset));
+
+	if (!m_featuresWatcher && m_pendingSamples.count() >= (format.sampleRate() * m_pendingChannels))
+	{
+		startExtraction();
+	}
+
+	if ((m_peaks.peakCount() - m_notifiedPeaks) >= 1024)
+	{
+		m_notifiedPeaks = m_peaks.peakCount();
+
+		emit peaksChanged();
+	}
+}
+
+void WaveformLoader::decodingFinished()
+{
+	m_peaks.finish();
+
+	m_decodingFinished = true;
+
+	if (m_featuresWatcher)
+	{
+		return;
+	}
+
+	if (m_pendingSamples.isEmpty())
+	{
+		finishLoading();
+	}
+	else
+	{
+		startExtraction();
+	}
+}
+
+void WaveformLoader::extractionFinished()
+{
+	m_featuresWatcher->deleteLater();
+	m_featuresWatcher = NULL;
+
+	if (!m_pendingSamples.isEmpty() && (m_decodingFinished || m_pendingSamples.count() >= (m_speech.sampleRate() * m_pendingChannels)))
+	{
+		startExtraction();
+	}
+	else if (m_decodingFinished)
+	{
+		finishLoading();
+	}
+}
+
+void WaveformLoader::decodingFailed(QAudioDecoder::Error error)
+{
+	Q_UNUSED(error)
+
+	cancel();
+
+	m_peaks.clear();
+	m_speech.clear();
+
+	emit peaksChanged();
+}
+
+void WaveformLoader::detectionFinished()
+{
+	m_speechSegments = m_speechWatcher->result();
+
+	m_speechWatcher->deleteLater();
+	m_speechWatcher = NULL;
+
+	emit speechDetected();
+}
+
+const WaveformPeaks* WaveformLoader::peaks() const
+{
+	return &m_peaks;
+}
+
+QVector<SpeechSegment> WaveformLoader::speechSegments() const
+{
+	return m_speechSegments;
+}
+
+QString WaveformLoader::fileName() const
+{
+	return m_fileName;
+}
+
+bool WaveformLoader::isDecoding() const
+{
+	return (m_decoder != NULL || m_featuresWatcher != NULL);
+}
+
+bool WaveformLoader::isDetecting() const
+{
+	return (m_speechWatcher != NULL);
+}
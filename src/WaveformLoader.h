@@ -0,0 +1,88 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef WAVEFORMLOADER_H
+#define WAVEFORMLOADER_H
+
+#include "SpeechDetector.h"
+#include "WaveformPeaks.h"
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QObject>
+#include <QtMultimedia/QAudioDecoder>
+
+class WaveformLoader : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum
+	{
+		SampleRate = 22050
+	};
+
+	explicit WaveformLoader(QObject *parent = NULL);
+
+	void load(const QString &fileName);
+	const WaveformPeaks* peaks() const;
+	QVector<SpeechSegment> speechSegments() const;
+	QString fileName() const;
+	bool isDecoding() const;
+	bool isDetecting() const;
+
+public slots:
+	void cancel();
+
+protected:
+	void startExtraction();
+	void finishLoading();
+	void startDetection();
+
+protected slots:
+	void bufferReady();
+	void decodingFinished();
+	void decodingFailed(QAudioDecoder::Error error);
+	void extractionFinished();
+	void detectionFinished();
+
+private:
+	QAudioDecoder *m_decoder;
+	QFutureWatcher<void> *m_featuresWatcher;
+	QFutureWatcher<QVector<SpeechSegment> > *m_speechWatcher;
+	WaveformPeaks m_peaks;
+	SpeechDetector m_speech;
+	QVector<SpeechSegment> m_speechSegments;
+	QVector<qint16> m_samples;
+	QVector<qint16> m_pendingSamples;
+	QString m_fileName;
+	QString m_cachePath;
+	QString m_speechCachePath;
+	int m_pendingChannels;
+	int m_notifiedPeaks;
+	bool m_decodingFinished;
+
+signals:
+	void peaksChanged();
+	void speechDetected();
+
+};
+
+#endif
@@ -0,0 +1,330 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#include "WaveformPeaks.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include <cmath>
+
+static const quint32 peaksMagic = 0x575A5357;
+static const quint32 peaksVersion = 1;
+
+WaveformPeaks::WaveformPeaks() : m_pendingMinimum(32767),
+	m_pendingMaximum(-32768),
+	m_pendingFrames(0),
+	m_sampleRate(0),
+	m_complete(false)
+{
+	clear();
+}
+
+void WaveformPeaks::clear()
+{
+	m_minimums.clear();
+	m_minimums.append(QVector<qint16>());
+	m_maximums.clear();
+	m_maximums.append(QVector<qint16>());
+	m_pendingMinimum = 32767;
+	m_pendingMaximum = -32768;
+	m_pendingFrames = 0;
+	m_sampleRate = 0;
+	m_complete = false;
+}
+
+void WaveformPeaks::setSampleRate(int rate)
+{
+	m_sampleRate = rate;
+}
+
+void WaveformPeaks::appendSamples(const qint16 *samples, int frames, int channels)
+{
+	if (channels <= 0)
+	{
+		return;
+	}
+
+	int frame = 0;
+
+	while (frame < frames)
+	{
+		const int count = qMin((frames - frame), (BlockFrames - m_pendingFrames));
+		qint16 minimum = 0;
+		qint16 maximum = 0;
+
+		reduce((samples + (frame * channels)), (count * channels), &minimum, &maximum);
+
+		m_pendingMinimum = qMin(m_pendingMinimum, minimum);
+		m_pendingMaximum = qMax(m_pendingMaximum, maximum);
+		m_pendingFrames += count;
+
+		frame += count;
+
+		if (m_pendingFrames == BlockFrames)
+		{
+			m_minimums[0].append(m_pendingMinimum);
+			m_maximums[0].append(m_pendingMaximum);
+
+			m_pendingMinimum = 32767;
+			m_pendingMaximum = -32768;
+			m_pendingFrames = 0;
+		}
+	}
+}
+
+void WaveformPeaks::finish()
+{
+	if (m_pendingFrames > 0)
+	{
+		m_minimums[0].append(m_pendingMinimum);
+		m_maximums[0].append(m_pendingMaximum);
+
+		m_pendingMinimum = 32767;
+		m_pendingMaximum = -32768;
+		m_pendingFrames = 0;
+	}
+
+	m_minimums.resize(1);
+	m_maximums.resize(1);
+
+	while (m_minimums.last().count() > 1)
+	{
+		const QVector<qint16> &lowerMinimums = m_minimums.last();
+		const QVector<qint16> &lowerMaximums = m_maximums.last();
+		const int lowerCount = lowerMinimums.count();
+		const int count = ((lowerCount + 1) / 2);
+		const int pairs = (lowerCount / 2);
+		QVector<qint16> minimums(count);
+		QVector<qint16> maximums(count);
+		const qint16 *sourceMinimums = lowerMinimums.constData();
+		const qint16 *sourceMaximums = lowerMaximums.constData();
+		qint16 *targetMinimums = minimums.data();
+		qint16 *targetMaximums = maximums.data();
+
+		for (int i = 0; i < pairs; ++i)
+		{
+			const qint16 firstMinimum = sourceMinimums[2 * i];
+			const qint16 secondMinimum = sourceMinimums[(2 * i) + 1];
+			const qint16 firstMaximum = sourceMaximums[2 * i];
+			const qint16 secondMaximum = sourceMaximums[(2 * i) + 1];
+
+			targetMinimums[i] = ((secondMinimum < firstMinimum) ? secondMinimum : firstMinimum);
+			targetMaximums[i] = ((secondMaximum > firstMaximum) ? secondMaximum : firstMaximum);
+		}
+
+		if (pairs < count)
+		{
+			targetMinimums[pairs] = sourceMinimums[lowerCount - 1];
+			targetMaximums[pairs] = sourceMaximums[lowerCount - 1];
+		}
+
+		m_minimums.append(minimums);
+		m_maximums.append(maximums);
+	}
+
+	m_complete = true;
+}
+
+bool WaveformPeaks::load(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic = 0;
+	quint32 version = 0;
+	qint32 sampleRate = 0;
+	QVector<qint16> minimums;
+	QVector<qint16> maximums;
+
+	stream >> magic >> version;
+
+	if (magic != peaksMagic || version != peaksVersion)
+	{
+		return false;
+	}
+
+	stream >> sampleRate >> minimums >> maximums;
+
+	if (stream.status() != QDataStream::Ok || sampleRate <= 0 || minimums.count() != maximums.count())
+	{
+		return false;
+	}
+
+	clear();
+
+	m_sampleRate = sampleRate;
+	m_minimums[0] = minimums;
+	m_maximums[0] = maximums;
+
+	finish();
+
+	return true;
+}
+
+bool WaveformPeaks::save(const QString &path) const
+{
+	QDir().mkpath(QFileInfo(path).absolutePath());
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << peaksMagic << peaksVersion << qint32(m_sampleRate) << m_minimums.first() << m_maximums.first();
+
+	return file.commit();
+}
+
+bool WaveformPeaks::peak(qint64 begin, qint64 end, qint16 *minimum, qint16 *maximum) const
+{
+	if (m_sampleRate <= 0 || end <= begin || begin < 0)
+	{
+		return false;
+	}
+
+	const double peaksPerMillisecond = (m_sampleRate / (1000.0 * BlockFrames));
+	const double span = ((end - begin) * peaksPerMillisecond);
+	int level = 0;
+
+	while ((level + 1) < m_minimums.count() && span >= (2 << (level + 1)))
+	{
+		++level;
+	}
+
+	const QVector<qint16> &minimums = m_minimums.at(level);
+	const QVector<qint16> &maximums = m_maximums.at(level);
+	const int first = (int(begin * peaksPerMillisecond) >> level);
+	const int last = qMin(minimums.count(), qMax((first + 1), ((int(std::ceil(end * peaksPerMillisecond)) + (1 << level) - 1) >> level)));
+
+	if (first >= last)
+	{
+		return false;
+	}
+
+	qint16 maximumOfMinimums = 0;
+	qint16 minimumOfMaximums = 0;
+
+	reduce((minimums.constData() + first), (last - first), minimum, &maximumOfMinimums);
+	reduce((maximums.constData() + first), (last - first), &minimumOfMaximums, maximum);
+
+	return true;
+}
+
+qint64 WaveformPeaks::duration() const
+{
+	return ((m_sampleRate > 0) ? ((qint64(m_minimums.first().count()) * BlockFrames * 1000) / m_sampleRate) : 0);
+}
+
+int WaveformPeaks::sampleRate() const
+{
+	return m_sampleRate;
+}
+
+int WaveformPeaks::levelCount() const
+{
+	return m_minimums.count();
+}
+
+int WaveformPeaks::peakCount(int level) const
+{
+	return m_minimums.value(level).count();
+}
+
+bool WaveformPeaks::isEmpty() const
+{
+	return m_minimums.first().isEmpty();
+}
+
+bool WaveformPeaks::isComplete() const
+{
+	return m_complete;
+}
+
+void WaveformPeaks::reduce(const qint16 *samples, int count, qint16 *minimum, qint16 *maximum)
+{
+	qint16 minimums[8] = {32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767};
+	qint16 maximums[8] = {-32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768};
+	int i = 0;
+
+	for (; (i + 8) <= count; i += 8)
+	{
+		for (int j = 0; j < 8; ++j)
+		{
+			minimums[j] = ((samples[i + j] < minimums[j]) ? samples[i + j] : minimums[j]);
+			maximums[j] = ((samples[i + j] > maximums[j]) ? samples[i + j] : maximums[j]);
+		}
+	}
+
+	for (; i < count; ++i)
+	{
+		minimums[0] = ((samples[i] < minimums[0]) ? samples[i] : minimums[0]);
+		maximums[0] = ((samples[i] > maximums[0]) ? samples[i] : maximums[0]);
+	}
+
+	*minimum = minimums[0];
+	*maximum = maximums[0];
+
+	for (int j = 1; j < 8; ++j)
+	{
+		*minimum = qMin(*minimum, minimums[j]);
+		*maximum = qMax(*maximum, maximums[j]);
+	}
+}
+
+QString WaveformPeaks::cacheKey(const QString &mediaFile)
+{
+	QFile file(mediaFile);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return QString();
+	}
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(file.read(65536));
+	hash.addData(QByteArray::number(file.size()));
+
+	return QString("%1-%2").arg(QString(hash.result().toHex())).arg(QFileInfo(mediaFile).lastModified().toMSecsSinceEpoch());
+}
+
+QString WaveformPeaks::cachePath(const QString &mediaFile)
+{
+	const QString key = cacheKey(mediaFile);
+
+	return (key.isEmpty() ? QString() : (QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QString("/waveforms/%1.dat").arg(key)));
+}
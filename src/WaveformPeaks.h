@@ -0,0 +1,65 @@
+/***********************************************************************************
+* Warzone 2100 Subtitles Editor
+* Copyright (C) 2010 - 2013 Michal Dutkiewicz aka Emdek <emdeck@gmail.com>
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*
+***********************************************************************************/
+
+
+#ifndef WAVEFORMPEAKS_H
+#define WAVEFORMPEAKS_H
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+class WaveformPeaks
+{
+public:
+	enum
+	{
+		BlockFrames = 256
+	};
+
+	WaveformPeaks();
+
+	void clear();
+	void setSampleRate(int rate);
+	void appendSamples(const qint16 *samples, int frames, int channels);
+	void finish();
+	bool load(const QString &path);
+	bool save(const QString &path) const;
+	bool peak(qint64 begin, qint64 end, qint16 *minimum, qint16 *maximum) const;
+	qint64 duration() const;
+	int sampleRate() const;
+	int levelCount() const;
+	int peakCount(int level = 0) const;
+	bool isEmpty() const;
+	bool isComplete() const;
+	static void reduce(const qint16 *samples, int count, qint16 *minimum, qint16 *maximum);
+	static QString cacheKey(const QString &mediaFile);
+	static QString cachePath(const QString &mediaFile);
+
+private:
+	QVector<QVector<qint16> > m_minimums;
+	QVector<QVector<qint16> > m_maximums;
+	qint16 m_pendingMinimum;
+	qint16 m_pendingMaximum;
+	int m_pendingFrames;
+	int m_sampleRate;
+	bool m_complete;
+};
+
+#endif
@@ -18,20 +18,68 @@
 *
 ***********************************************************************************/
 
+#include "SubtitlesBatch.h"
 #include "SubtitlesEditor.h"
+#include "SubtitlesTrace.h"
 
 #include <QtWidgets/QApplication>
 
+void setupApplication(QCoreApplication *application)
+{
+	application->setApplicationName("WZSubtitlesEditor");
+	application->setApplicationVersion("1.1");
+	application->setOrganizationName("Warzone2100");
+	application->setOrganizationDomain("wz2100.net");
+}
+
 int main(int argc, char *argv[])
 {
-	QApplication application(argc, argv);
-	application.setApplicationName("WZSubtitlesEditor");
-	application.setApplicationVersion("1.1");
-	application.setOrganizationName("Warzone2100");
-	application.setOrganizationDomain("wz2100.net");
+	bool batch = false;
+
+	if (!qEnvironmentVariableIsEmpty("SUBTITLES_TRACE"))
+	{
+		SubtitlesTrace::enable(QString::fromLocal8Bit(qgetenv("SUBTITLES_TRACE")));
+	}
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (qstrcmp(argv[i], "--batch") == 0 || qstrncmp(argv[i], "--batch=", 8) == 0)
+		{
+			batch = true;
+		}
+		else if (qstrcmp(argv[i], "--trace") == 0 && (i + 1) < argc)
+		{
+			SubtitlesTrace::enable(QString::fromLocal8Bit(argv[i + 1]));
+		}
+		else if (qstrncmp(argv[i], "--trace=", 8) == 0)
+		{
+			SubtitlesTrace::enable(QString::fromLocal8Bit(argv[i] + 8));
+		}
+	}
+
+	int result = 0;
+
+	if (batch)
+	{
+		QCoreApplication application(argc, argv);
+
+		setupApplication(&application);
+
+		result = SubtitlesBatch::run(application.arguments());
+	}
+	else
+	{
+		QApplication application(argc, argv);
+
+		setupApplication(&application);
+
+		MainWindow window;
+		window.show();
+
+		result = application.exec();
+	}
 
-	MainWindow window;
-	window.show();
+	SubtitlesTrace::save();
 
-	return application.exec();
+	return result;
 }